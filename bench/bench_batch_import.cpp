@@ -0,0 +1,105 @@
+/**
+ * @file bench_batch_import.cpp
+ * @brief Импорт задач: add_task по одной против User::apply_batch.
+ *
+ * Запуск: bench_batch_import [количество] — по умолчанию 100 тыс. задач.
+ * Для каждого режима печатается время вставки, время сохранения, размер
+ * файлов на диске и число записей в истории отмены.
+ */
+
+#include "Task.h"
+#include "User.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void remove_user_files(const std::string& name) {
+    std::error_code ec;
+    std::filesystem::remove(name + "_tasks.bin", ec);
+    std::filesystem::remove(name + "_tasks.log", ec);
+}
+
+uintmax_t disk_bytes(const std::string& name) {
+    uintmax_t total = 0;
+    std::error_code ec;
+    for (const char* suffix : {"_tasks.bin", "_tasks.log"}) {
+        uintmax_t size = std::filesystem::file_size(name + suffix, ec);
+        if (!ec) total += size;
+    }
+    return total;
+}
+
+Task make_task(size_t i) {
+    return Task("Task #" + std::to_string(i), "Description of task number " + std::to_string(i),
+                static_cast<Priority>(i % 3), i % 4 ? Status::Active : Status::Done,
+                "2030-01-" + std::string(i % 28 < 9 ? "0" : "") + std::to_string(i % 28 + 1) + " 12:00", {});
+}
+
+/// Как прежде делал интерфейс: add_task и сохранение после каждой задачи.
+void run_add_and_save_each(size_t count) {
+    const std::string name = "bench_batch_each";
+    remove_user_files(name);
+    User user(name);
+    auto start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        user.add_task(make_task(i));
+        user.save_to_file();
+    }
+    double total = ms_since(start);
+    std::printf("  add_task + save each    %9.1f ms total                 %9ju bytes, %zu undo entries\n", total,
+                disk_bytes(name), user.undo_history().size());
+    remove_user_files(name);
+}
+
+void run_add_then_save(size_t count) {
+    const std::string name = "bench_batch_add";
+    remove_user_files(name);
+    User user(name);
+    auto start = Clock::now();
+    for (size_t i = 0; i < count; ++i) user.add_task(make_task(i));
+    double insert = ms_since(start);
+    start = Clock::now();
+    user.save_to_file();
+    double save = ms_since(start);
+    std::printf("  add_task, one save      %9.1f ms insert %9.1f ms save %9ju bytes, %zu undo entries\n", insert,
+                save, disk_bytes(name), user.undo_history().size());
+    remove_user_files(name);
+}
+
+void run_batch(size_t count) {
+    const std::string name = "bench_batch_apply";
+    remove_user_files(name);
+    User user(name);
+    auto start = Clock::now();
+    std::vector<TaskOp> ops;
+    ops.reserve(count);
+    for (size_t i = 0; i < count; ++i) ops.push_back(TaskOp::add(make_task(i)));
+    user.apply_batch(std::move(ops));
+    double insert = ms_since(start);
+    start = Clock::now();
+    user.save_to_file();
+    double save = ms_since(start);
+    std::printf("  apply_batch, one save   %9.1f ms insert %9.1f ms save %9ju bytes, %zu undo entries\n", insert,
+                save, disk_bytes(name), user.undo_history().size());
+    remove_user_files(name);
+}
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    std::printf("%zu tasks:\n", count);
+    run_add_and_save_each(count);
+    run_add_then_save(count);
+    run_batch(count);
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file bench_codecs.cpp
+ * @brief Размер и скорость кодирования/декодирования задач в каждом формате TaskCodec.
+ *
+ * Для сравнения первой строкой выводится прежний формат сохранения —
+ * JSON с отступами (dump(4)) и разбором через DOM.
+ * Запуск: bench_codecs [количество задач], по умолчанию 100000.
+ */
+
+#include "Task.h"
+#include "TaskCodec.h"
+#include "TaskSaxLoader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+TagDictionary dictionary;
+
+std::vector<Task> make_tasks(size_t count) {
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        tasks.push_back(Task{"Task #" + std::to_string(i), "Description of task number " + std::to_string(i),
+                             static_cast<Priority>(i % 3), i % 4 ? Status::Active : Status::Done,
+                             "2030-01-15 12:00", {dictionary.intern("work"), dictionary.intern("tag" + std::to_string(i % 50))}});
+    }
+    return tasks;
+}
+
+double ms_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* name, size_t bytes, double encode_ms, double decode_ms) {
+    double mb = bytes / (1024.0 * 1024.0);
+    std::printf("%-14s %10zu bytes  encode %8.1f ms (%7.1f MB/s)  decode %8.1f ms (%7.1f MB/s)\n",
+                name, bytes, encode_ms, mb / (encode_ms / 1000.0), decode_ms, mb / (decode_ms / 1000.0));
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const std::vector<Task> tasks = make_tasks(count);
+    std::printf("%zu tasks\n", count);
+
+    {
+        auto start = std::chrono::steady_clock::now();
+        json items;
+        for (const auto& t : tasks) items.push_back(t.to_json(dictionary));
+        std::string text = items.dump(4);
+        double encode_ms = ms_since(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<Task> decoded;
+        for (const auto& item : json::parse(text)) decoded.push_back(Task::from_json(item, dictionary));
+        report("json (pretty)", text.size(), encode_ms, ms_since(start));
+    }
+
+    for (const TaskCodec* codec : TaskCodec::all()) {
+        auto start = std::chrono::steady_clock::now();
+        std::ostringstream out(std::ios::binary);
+        codec->encode(tasks, dictionary, out);
+        std::string bytes = out.str();
+        double encode_ms = ms_since(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<Task> decoded;
+        decoded.reserve(count);
+        std::istringstream in(bytes, std::ios::binary);
+        TaskSaxLoader loader(decoded, dictionary);
+        if (!codec->decode(in, loader) || decoded.size() != count) {
+            std::fprintf(stderr, "%s: decode failed: %s\n", codec->name(), loader.error().c_str());
+            return 1;
+        }
+        report(codec->name(), bytes.size(), encode_ms, ms_since(start));
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file bench_deadline_parse.cpp
+ * @brief Разбор дедлайнов: std::istringstream + std::get_time + std::mktime против parse_deadline.
+ *
+ * Запуск: bench_deadline_parse [количество строк] — по умолчанию 1 млн.
+ */
+
+#include "Deadline.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+/// Прежний разбор из isOverdue/isUrgent.
+DeadlineTime parse_with_get_time(const std::string& text) {
+    std::tm tm = {};
+    std::istringstream ss(text);
+    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
+    if (ss.fail()) return kNoDeadline;
+    return static_cast<DeadlineTime>(std::mktime(&tm));
+}
+
+template <typename F>
+double measure_ms(const std::vector<std::string>& input, F&& parse, int64_t& checksum) {
+    auto start = std::chrono::steady_clock::now();
+    checksum = 0;
+    for (const auto& text : input) checksum += parse(text);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::vector<std::string> input;
+    input.reserve(count);
+    char buf[32];
+    for (size_t i = 0; i < count; ++i) {
+        std::snprintf(buf, sizeof(buf), "%04zu-%02zu-%02zu %02zu:%02zu", 2000 + i % 60, 1 + i % 12, 1 + i % 28,
+                      i % 24, i % 60);
+        input.push_back(buf);
+    }
+
+    int64_t old_sum = 0, new_sum = 0;
+    double old_ms = measure_ms(input, parse_with_get_time, old_sum);
+    double new_ms = measure_ms(input, [](const std::string& s) { return parse_deadline(s); }, new_sum);
+
+    std::printf("%zu deadlines\n", count);
+    std::printf("get_time + mktime: %8.1f ms (%6.1f ns/deadline)\n", old_ms, old_ms * 1e6 / count);
+    std::printf("parse_deadline:    %8.1f ms (%6.1f ns/deadline)\n", new_ms, new_ms * 1e6 / count);
+    std::printf("speedup: %.1fx, results %s\n", old_ms / new_ms, old_sum == new_sum ? "match" : "DIFFER");
+    return old_sum == new_sum ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file bench_json_writer.cpp
+ * @brief Сравнение сохранения через JSON-дерево (to_json + dump) и через TaskJsonWriter.
+ *
+ * Запуск: bench_json_writer [количество задач], по умолчанию 1000000.
+ */
+
+#include "Task.h"
+#include "TaskJsonWriter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    TagDictionary dictionary;
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        tasks.push_back(Task{"Task #" + std::to_string(i), "Description of task \"" + std::to_string(i) + "\"",
+                             static_cast<Priority>(i % 3), i % 4 ? Status::Active : Status::Done,
+                             "2030-01-15 12:00", {dictionary.intern("work"), dictionary.intern("tag" + std::to_string(i % 50))}});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    json items = json::array();
+    for (const auto& t : tasks) items.push_back(t.to_json(dictionary));
+    std::string dom = items.dump();
+    double dom_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    std::ostringstream out;
+    {
+        TaskJsonWriter writer(out, dictionary);
+        writer.write_array(tasks);
+    }
+    std::string streamed = out.str();
+    double writer_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%zu tasks, %zu bytes, identical: %s\n", count, streamed.size(), dom == streamed ? "yes" : "NO");
+    std::printf("dom + dump      %8.1f ms\n", dom_ms);
+    std::printf("TaskJsonWriter  %8.1f ms  (%.1fx)\n", writer_ms, dom_ms / writer_ms);
+    return dom == streamed ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file bench_load.cpp
+ * @brief Сравнение загрузки JSON через DOM (file >> j) и через TaskSaxLoader.
+ *
+ * Без аргументов генерирует файлы на 100k и 1M задач и для каждого режима
+ * запускает себя отдельным процессом, чтобы пиковый RSS не смешивался.
+ * Запуск одного замера: bench_load <dom|sax> <файл>.
+ */
+
+#include "Task.h"
+#include "TaskSaxLoader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+TagDictionary dictionary;
+
+void generate(const std::string& path, size_t count) {
+    std::ofstream file(path);
+    file << "[\n";
+    for (size_t i = 0; i < count; ++i) {
+        Task t{"Task #" + std::to_string(i), "Description of task number " + std::to_string(i),
+               static_cast<Priority>(i % 3), i % 4 ? Status::Active : Status::Done,
+               "2030-01-" + std::string(i % 28 < 9 ? "0" : "") + std::to_string(i % 28 + 1) + " 12:00",
+               {dictionary.intern("work"), dictionary.intern("tag" + std::to_string(i % 50))}};
+        file << t.to_json(dictionary).dump(4) << (i + 1 < count ? ",\n" : "\n");
+    }
+    file << "]\n";
+}
+
+long peak_rss_kb() {
+#ifndef _WIN32
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+int measure(const std::string& mode, const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Task> tasks;
+    std::ifstream file(path, std::ios::binary);
+    if (mode == "dom") {
+        json j;
+        file >> j;
+        for (const auto& item : j) tasks.push_back(Task::from_json(item, dictionary));
+    } else {
+        TaskSaxLoader loader(tasks, dictionary);
+        if (!loader.load(file)) {
+            std::cerr << loader.error() << "\n";
+            return 1;
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-4s %9zu tasks  %9.1f ms  peak RSS %8ld KB\n", mode.c_str(), tasks.size(), ms, peak_rss_kb());
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3) return measure(argv[1], argv[2]);
+
+    for (size_t count : {size_t{100000}, size_t{1000000}}) {
+        const std::string path = "bench_load_" + std::to_string(count) + ".json";
+        generate(path, count);
+        for (const char* mode : {"dom", "sax"}) {
+            std::string cmd = std::string(argv[0]) + " " + mode + " " + path;
+            if (std::system(cmd.c_str()) != 0) return 1;
+        }
+        std::remove(path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file bench_partition.cpp
+ * @brief Выборка задач по статусу и приоритету: перебор с копированием против множеств TaskStore.
+ *
+ * Запуск: bench_partition — прогоны на 10 тыс., 100 тыс. и 1 млн задач.
+ */
+
+#include "Task.h"
+#include "TaskStore.h"
+#include "TaskView.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int kRounds = 10;
+
+template <typename F>
+double measure_us(F&& run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRounds; ++r) run();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kRounds;
+}
+
+void run(size_t count) {
+    TaskStore store;
+    store.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        store.add(Task("Task #" + std::to_string(i), "Description of task " + std::to_string(i),
+                       static_cast<Priority>(i % 3), i % 4 ? Status::Active : Status::Done,
+                       "2030-01-15 12:00", {}));
+    }
+
+    // Прежний filter_by_status: перебор всех задач и копия каждой подходящей.
+    size_t copied = 0;
+    double copy_us = measure_us([&] {
+        std::vector<Task> result;
+        for (const Task& t : store.tasks()) {
+            if (t.status == Status::Active && t.priority == Priority::High) result.push_back(t);
+        }
+        copied = result.size();
+    });
+
+    size_t status_size = 0;
+    double status_us = measure_us([&] {
+        TaskView view(store, &store.status_slots(Status::Active));
+        status_size = view.size();
+    });
+
+    size_t viewed = 0;
+    double view_us = measure_us([&] {
+        TaskView view(store, store.status_slots(Status::Active) & store.priority_slots(Priority::High));
+        viewed = view.size();
+    });
+
+    size_t walked = 0;
+    double walk_us = measure_us([&] {
+        TaskView view(store, store.status_slots(Status::Active) & store.priority_slots(Priority::High));
+        walked = 0;
+        for (const Task& t : view) walked += t.id != 0;
+    });
+
+    std::printf("%8zu tasks: Active+High = %zu%s\n", count, viewed, copied == viewed && walked == viewed ? "" : " MISMATCH");
+    std::printf("  scan + copy             %10.1f us\n", copy_us);
+    std::printf("  Active view (O(1))      %10.1f us  (%zu tasks)\n", status_us, status_size);
+    std::printf("  Active+High view        %10.1f us\n", view_us);
+    std::printf("  Active+High view + walk %10.1f us\n", walk_us);
+}
+}
+
+int main() {
+    for (size_t count : {10000, 100000, 1000000}) run(count);
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file bench_snapshot_load.cpp
+ * @brief Холодный старт: User::load_from_file из двоичного снимка.
+ *
+ * Генерирует снимок на заданное число задач (по умолчанию 1000000) и
+ * несколько раз загружает его в пользователя. Цель — заметно меньше 100 мс
+ * на 1M задач. Отдельно меряется первый полный обход списка: он собирает
+ * из отображения все записи, которые загрузка оставила несобранными.
+ * Запуск: bench_snapshot_load [количество задач].
+ */
+
+#include "Task.h"
+#include "TaskSnapshot.h"
+#include "User.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int kRounds = 5;
+const std::string kUser = "bench_snapshot_load";
+
+void generate(size_t count) {
+    TagDictionary dictionary;
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Task t{"Task #" + std::to_string(i), "Description of task number " + std::to_string(i),
+               static_cast<Priority>(i % 3), i % 4 ? Status::Active : Status::Done,
+               "2030-01-" + std::string(i % 28 < 9 ? "0" : "") + std::to_string(i % 28 + 1) + " 12:00",
+               {dictionary.intern("work"), dictionary.intern("tag" + std::to_string(i % 50))}};
+        t.id = i + 1;
+        tasks.push_back(std::move(t));
+    }
+    TaskSnapshot::write(kUser + "_tasks.bin", tasks, dictionary, 1);
+}
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    generate(count);
+
+    std::vector<double> load_times, scan_times;
+    size_t loaded = 0;
+    for (int r = 0; r < kRounds; ++r) {
+        User user(kUser);
+        auto start = std::chrono::steady_clock::now();
+        user.load_from_file();
+        auto loaded_at = std::chrono::steady_clock::now();
+        for (const Task& t : user.get_tasks()) loaded += !t.title.empty();
+        auto scanned_at = std::chrono::steady_clock::now();
+        load_times.push_back(std::chrono::duration<double, std::milli>(loaded_at - start).count());
+        scan_times.push_back(std::chrono::duration<double, std::milli>(scanned_at - loaded_at).count());
+    }
+    std::sort(load_times.begin(), load_times.end());
+    std::sort(scan_times.begin(), scan_times.end());
+    std::printf("%zu tasks  load best %7.1f ms  median %7.1f ms\n", loaded / kRounds, load_times.front(),
+                load_times[kRounds / 2]);
+    std::printf("%zu tasks  first full scan best %7.1f ms  median %7.1f ms\n", loaded / kRounds, scan_times.front(),
+                scan_times[kRounds / 2]);
+
+    std::remove((kUser + "_tasks.bin").c_str());
+    std::remove((kUser + "_tasks.log").c_str());
+    return 0;
+}
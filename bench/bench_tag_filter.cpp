@@ -0,0 +1,68 @@
+/**
+ * @file bench_tag_filter.cpp
+ * @brief Сравнение фильтрации по сочетанию тегов: перебор задач против множеств позиций.
+ *
+ * Запуск: bench_tag_filter [количество задач], по умолчанию 1000000.
+ */
+
+#include "Task.h"
+#include "TaskStore.h"
+#include "TagQuery.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int kRounds = 20;
+
+template <typename F>
+double measure_us(F&& run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRounds; ++r) run();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kRounds;
+}
+
+bool has(const Task& t, TagId tag) {
+    return std::find(t.tags.begin(), t.tags.end(), tag) != t.tags.end();
+}
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    TagDictionary dictionary;
+    TagId work = dictionary.intern("work");
+    TagId urgent = dictionary.intern("urgent");
+    TagId blocked = dictionary.intern("blocked");
+    TaskStore store;
+    store.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<TagId> tags;
+        if (i % 2 == 0) tags.push_back(work);
+        if (i % 7 == 0) tags.push_back(urgent);
+        if (i % 5 == 0) tags.push_back(blocked);
+        tags.push_back(dictionary.intern("tag" + std::to_string(i % 50)));
+        store.add(Task("Task #" + std::to_string(i), "", Priority::Low, Status::Active, "", tags));
+    }
+
+    TagQuery query;
+    std::string error;
+    TagQuery::parse("work AND urgent AND NOT blocked", query, error);
+
+    size_t scanned = 0;
+    double scan_us = measure_us([&] {
+        scanned = 0;
+        for (const Task& t : store.tasks()) {
+            if (has(t, work) && has(t, urgent) && !has(t, blocked)) ++scanned;
+        }
+    });
+    size_t selected = 0;
+    double bitmap_us = measure_us([&] { selected = query.evaluate(store, dictionary).cardinality(); });
+
+    std::printf("%zu tasks, 'work AND urgent AND NOT blocked' matches %zu (scan %zu)\n", count, selected, scanned);
+    std::printf("linear scan   %10.1f us\n", scan_us);
+    std::printf("bitmap query  %10.1f us  (%.0fx)\n", bitmap_us, scan_us / bitmap_us);
+    return selected == scanned ? 0 : 1;
+}
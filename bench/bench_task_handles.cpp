@@ -0,0 +1,190 @@
+/**
+ * @file bench_task_handles.cpp
+ * @brief Копии задач против общих ручек (TaskHandle): число выделений памяти и время.
+ *
+ * Запуск: bench_task_handles — 100 тыс. задач; для каждого пути печатается,
+ * сколько раз вызывался operator new и сколько это заняло.
+ */
+
+#include "Task.h"
+#include "TaskStore.h"
+#include "TaskView.h"
+#include "User.h"
+#include "PersistentVector.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Выделения считаются заменой всех вариантов operator new/delete: обычных,
+// массивов, nothrow и с выравниванием, чтобы каждая пара оставалась согласованной.
+// Выделение и освобождение вынесены в невстраиваемые функции: иначе GCC видит
+// free() на указателе из new и предупреждает (-Wmismatched-new-delete).
+namespace {
+std::atomic<size_t> allocations{0};
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void* counted_alloc(size_t size, size_t alignment) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc требует размер, кратный выравниванию.
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+BENCH_NOINLINE void counted_free(void* p, size_t alignment) noexcept {
+#ifdef _WIN32
+    if (alignment > alignof(std::max_align_t)) {
+        _aligned_free(p);
+        return;
+    }
+#else
+    (void)alignment;
+#endif
+    std::free(p);
+}
+
+void* counted_new(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    if (void* p = counted_alloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+constexpr size_t kPlain = alignof(std::max_align_t);
+}
+
+void* operator new(size_t size) { return counted_new(size); }
+void* operator new[](size_t size) { return counted_new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, kPlain); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, kPlain); }
+void* operator new(size_t size, std::align_val_t al) { return counted_new(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return counted_new(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<size_t>(al));
+}
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<size_t>(al));
+}
+
+void operator delete(void* p) noexcept { counted_free(p, kPlain); }
+void operator delete[](void* p) noexcept { counted_free(p, kPlain); }
+void operator delete(void* p, size_t) noexcept { counted_free(p, kPlain); }
+void operator delete[](void* p, size_t) noexcept { counted_free(p, kPlain); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p, kPlain); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p, kPlain); }
+void operator delete(void* p, std::align_val_t al) noexcept { counted_free(p, static_cast<size_t>(al)); }
+void operator delete[](void* p, std::align_val_t al) noexcept { counted_free(p, static_cast<size_t>(al)); }
+void operator delete(void* p, size_t, std::align_val_t al) noexcept { counted_free(p, static_cast<size_t>(al)); }
+void operator delete[](void* p, size_t, std::align_val_t al) noexcept { counted_free(p, static_cast<size_t>(al)); }
+void operator delete(void* p, std::align_val_t al, const std::nothrow_t&) noexcept {
+    counted_free(p, static_cast<size_t>(al));
+}
+void operator delete[](void* p, std::align_val_t al, const std::nothrow_t&) noexcept {
+    counted_free(p, static_cast<size_t>(al));
+}
+
+namespace {
+constexpr size_t kTasks = 100000;
+constexpr size_t kEdits = 1000;
+
+/// Выделения и время одного прогона.
+struct Cost {
+    size_t allocations;
+    double ms;
+};
+
+template <typename F>
+Cost measure(F&& run) {
+    size_t before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    run();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return Cost{allocations.load() - before, ms};
+}
+
+void report(const char* name, Cost copy, Cost shared) {
+    std::printf("%-28s copies %9zu allocs %8.2f ms | handles %9zu allocs %8.2f ms\n", name, copy.allocations,
+                copy.ms, shared.allocations, shared.ms);
+}
+
+Task make_task(size_t i, std::vector<TagId> tags) {
+    return Task("Task number " + std::to_string(i) + " with a title", "Description of task " + std::to_string(i) +
+                " that does not fit into the small string buffer", static_cast<Priority>(i % 3),
+                i % 4 ? Status::Active : Status::Done, "2030-01-15 12:00", std::move(tags));
+}
+}
+
+int main() {
+    User user("bench_task_handles");
+    for (size_t i = 0; i < kTasks; ++i) user.add_task(make_task(i, {}));
+
+    // Поиск: прежний search_tasks копировал каждую найденную задачу.
+    size_t copied = 0, shared = 0;
+    Cost search_copy = measure([&] {
+        std::vector<Task> results;
+        for (const Task& t : user.get_tasks()) {
+            if (t.description.find("task") != std::string::npos) results.push_back(t);
+        }
+        copied = results.size();
+    });
+    Cost search_shared = measure([&] { shared = user.search_tasks("task").size(); });
+    report("search_tasks", search_copy, search_shared);
+
+    // Фильтр по тегу: прежний filter_by_tag возвращал TaskView::to_vector().
+    TaskStore store;
+    for (size_t i = 0; i < kTasks; ++i) store.add(make_task(i, {i % 2 ? TagId(1) : TagId(2), 3}));
+    Cost tag_copy = measure([&] { copied += TaskView(store, &store.tag_slots(1)).to_vector().size(); });
+    Cost tag_shared = measure([&] { shared += TaskView(store, &store.tag_slots(1)).handles().size(); });
+    report("filter_by_tag", tag_copy, tag_shared);
+
+    // Правка при живом снимке (фоновая запись): копируется лист из 32 элементов.
+    PersistentVector<Task> plain;
+    for (size_t i = 0; i < kTasks; ++i) plain.push_back(make_task(i, {1, 3}));
+    Cost edit_copy = measure([&] {
+        for (size_t e = 0; e < kEdits; ++e) {
+            PersistentVector<Task> snapshot = plain;
+            Task t = plain[e * 97 % kTasks];
+            t.status = Status::Done;
+            plain.set(e * 97 % kTasks, std::move(t));
+        }
+    });
+    Cost edit_shared = measure([&] {
+        for (size_t e = 0; e < kEdits; ++e) {
+            TaskTable snapshot = store.records();
+            Task t = store.record(e * 97 % kTasks);
+            t.status = Status::Done;
+            store.assign(e * 97 % kTasks, std::move(t));
+        }
+    });
+    report("edit with live snapshot", edit_copy, edit_shared);
+
+    // Запись отмены: прежде копия старой задачи, теперь её ручка.
+    std::vector<Task> undo_copies;
+    std::vector<TaskHandle> undo_handles;
+    undo_copies.reserve(kEdits);
+    undo_handles.reserve(kEdits);
+    Cost undo_copy = measure([&] {
+        for (size_t e = 0; e < kEdits; ++e) undo_copies.push_back(store.record(e));
+    });
+    Cost undo_shared = measure([&] {
+        for (size_t e = 0; e < kEdits; ++e) undo_handles.push_back(store.handle(e));
+    });
+    report("undo record", undo_copy, undo_shared);
+
+    if (copied != shared) std::printf("MISMATCH: %zu vs %zu\n", copied, shared);
+    return 0;
+}
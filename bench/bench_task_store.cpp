@@ -0,0 +1,72 @@
+/**
+ * @file bench_task_store.cpp
+ * @brief Сравнение сканирования по статусу и приоритету: вектор Task против столбцов TaskStore.
+ *
+ * Запуск: bench_task_store [количество задач], по умолчанию 1000000.
+ */
+
+#include "Task.h"
+#include "TaskStore.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int kRounds = 20;
+
+template <typename F>
+double measure(F&& scan) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRounds; ++r) scan();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / kRounds;
+}
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    TagDictionary dictionary;
+    std::vector<Task> plain;
+    TaskStore store;
+    plain.reserve(count);
+    store.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Task t{"Task #" + std::to_string(i), "Description of task " + std::to_string(i),
+               static_cast<Priority>(i % 3), i % 4 ? Status::Active : Status::Done,
+               "2030-01-15 12:00", {dictionary.intern("work"), dictionary.intern("tag" + std::to_string(i % 50))}};
+        t.id = store.add(t);
+        plain.push_back(std::move(t));
+    }
+
+    volatile size_t sink = 0;
+    double plain_status = measure([&] {
+        size_t n = 0;
+        for (const auto& t : plain) n += t.status == Status::Done;
+        sink = sink + n;
+    });
+    double store_status = measure([&] {
+        size_t n = 0;
+        for (size_t i = 0; i < store.slot_count(); ++i) n += store.id(i) != 0 && store.status(i) == Status::Done;
+        sink = sink + n;
+    });
+    double plain_priority = measure([&] {
+        size_t counts[3] = {};
+        for (const auto& t : plain) ++counts[static_cast<size_t>(t.priority)];
+        sink = sink + counts[2];
+    });
+    double store_priority = measure([&] {
+        size_t counts[3] = {};
+        for (size_t i = 0; i < store.slot_count(); ++i) {
+            if (store.id(i) != 0) ++counts[static_cast<size_t>(store.priority(i))];
+        }
+        sink = sink + counts[2];
+    });
+
+    std::printf("%zu tasks, sizeof(Task) = %zu bytes\n", count, sizeof(Task));
+    std::printf("count by status    vector<Task> %7.2f ms   TaskStore %7.2f ms  (%.1fx)\n",
+                plain_status, store_status, plain_status / store_status);
+    std::printf("count by priority  vector<Task> %7.2f ms   TaskStore %7.2f ms  (%.1fx)\n",
+                plain_priority, store_priority, plain_priority / store_priority);
+    return 0;
+}
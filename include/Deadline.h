@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+/// Момент дедлайна в секундах от эпохи Unix.
+using DeadlineTime = int64_t;
+
+/// Значение для пустого или нераспознанного дедлайна.
+constexpr DeadlineTime kNoDeadline = std::numeric_limits<DeadlineTime>::max();
+
+/// Календарные поля дедлайна (локальное время).
+struct DeadlineDate {
+    int year = 1970; ///< Год.
+    int month = 0;   ///< Месяц 0..11, как в std::tm.
+    int day = 1;     ///< День месяца, начиная с 1.
+    int hour = 0;    ///< Час.
+    int minute = 0;  ///< Минута.
+};
+
+/**
+ * @brief Разбирает дедлайн в формате "YYYY-MM-DD HH:MM" (локальное время).
+ *
+ * Строка разбирается без выделения памяти и без std::mktime: цифры
+ * складываются напрямую, дата переводится в дни от эпохи формулой
+ * григорианского календаря. Смещение часового пояса берётся из std::mktime
+ * один раз на месяц и кэшируется в потоке. Как и прежде, время считается
+ * стандартным (без перехода на летнее).
+ *
+ * Формат строгий: ровно 16 символов, месяц 01..12, день в пределах месяца,
+ * часы 00..23, минуты 00..59.
+ * @param text Строка дедлайна.
+ * @return Момент дедлайна или kNoDeadline, если строка не распознана.
+ */
+DeadlineTime parse_deadline(std::string_view text);
+
+/**
+ * @brief Момент по календарной дате (локальное время, как в parse_deadline).
+ *
+ * Выход за пределы полей нормализуется: месяц 12 — январь следующего года,
+ * день 32 — следующий месяц.
+ * @param year Год.
+ * @param month Месяц 0..11.
+ * @param day День месяца, начиная с 1.
+ * @param hour Час.
+ * @param minute Минута.
+ */
+DeadlineTime make_deadline(int year, int month, int day, int hour = 0, int minute = 0);
+
+/**
+ * @brief Раскладывает момент на календарные поля (обратно к make_deadline).
+ * @param time Момент дедлайна (не kNoDeadline).
+ */
+DeadlineDate split_deadline(DeadlineTime time);
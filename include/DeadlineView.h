@@ -0,0 +1,87 @@
+#pragma once
+#include "TaskStore.h"
+#include <cstddef>
+#include <iterator>
+#include <set>
+
+/**
+ * @class DeadlineView
+ * @brief Обход задач по дедлайну курсором по упорядоченному индексу TaskStore.
+ *
+ * Задачи не копируются и не сортируются: итератор идёт по индексу
+ * (дедлайн, идентификатор) вперёд или назад и находит запись по
+ * идентификатору за O(1). Выборка действительна до следующего изменения задач.
+ */
+class DeadlineView {
+public:
+    using Cursor = std::set<TaskStore::DeadlineKey>::const_iterator;
+
+    /// Итератор по задачам в порядке дедлайна.
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Task;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Task*;
+        using reference = const Task&;
+
+        iterator(const TaskStore* store, Cursor pos, bool descending)
+            : store(store), pos(pos), descending(descending) {}
+
+        reference operator*() const { return store->record(slot()); }
+        pointer operator->() const { return &store->record(slot()); }
+
+        /// Позиция текущей задачи в хранилище.
+        size_t slot() const { return store->find(key().second); }
+
+        /// Дедлайн текущей задачи.
+        DeadlineTime deadline() const { return key().first; }
+
+        iterator& operator++() {
+            if (descending) --pos;
+            else ++pos;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const iterator& other) const { return pos == other.pos; }
+        bool operator!=(const iterator& other) const { return pos != other.pos; }
+
+    private:
+        // При обходе назад курсор указывает на элемент после текущего, как в std::reverse_iterator.
+        const TaskStore::DeadlineKey& key() const { return descending ? *std::prev(pos) : *pos; }
+
+        const TaskStore* store; ///< Хранилище задач.
+        Cursor pos;             ///< Положение в индексе.
+        bool descending;        ///< Обход по убыванию.
+    };
+
+    /**
+     * @brief Создаёт выборку по отрезку индекса.
+     * @param store Хранилище задач.
+     * @param first Начало отрезка индекса.
+     * @param last Конец отрезка индекса.
+     * @param descending Обходить по убыванию дедлайна.
+     */
+    DeadlineView(const TaskStore& store, Cursor first, Cursor last, bool descending = false)
+        : store(&store), first(first), last(last), descending(descending) {}
+
+    iterator begin() const { return iterator(store, descending ? last : first, descending); }
+    iterator end() const { return iterator(store, descending ? first : last, descending); }
+
+    bool empty() const { return first == last; }
+
+    /// Количество задач (линейно по длине отрезка).
+    size_t size() const { return static_cast<size_t>(std::distance(first, last)); }
+
+private:
+    const TaskStore* store; ///< Хранилище задач.
+    Cursor first;           ///< Начало отрезка индекса.
+    Cursor last;            ///< Конец отрезка индекса.
+    bool descending;        ///< Обход по убыванию.
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class IdIndex
+ * @brief Хеш-таблица «идентификатор задачи → позиция в хранилище».
+ *
+ * Открытая адресация с линейным пробированием; при удалении следующие
+ * элементы цепочки сдвигаются назад, поэтому «надгробия» не нужны.
+ * Идентификатор 0 зарезервирован под пустую ячейку.
+ */
+class IdIndex {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Добавляет или обновляет позицию задачи.
+     * @param id Идентификатор (не 0).
+     * @param slot Позиция задачи.
+     */
+    void insert(uint64_t id, size_t slot);
+
+    /**
+     * @brief Заполняет таблицу заново: идентификатор ids[i] получает позицию i.
+     *
+     * Для загрузки большого списка: ячейки следующих идентификаторов
+     * запрашиваются в кэш заранее, и промахи по таблице перекрываются.
+     * Нулевые и повторные (после первого) идентификаторы не добавляются.
+     * @param ids Идентификаторы по позициям.
+     * @return Позиции, идентификаторы которых не добавлены.
+     */
+    std::vector<size_t> build(const std::vector<uint64_t>& ids);
+
+    /**
+     * @brief Удаляет идентификатор.
+     * @param id Идентификатор.
+     * @return true, если идентификатор был в таблице.
+     */
+    bool erase(uint64_t id);
+
+    /**
+     * @brief Ищет позицию задачи.
+     * @param id Идентификатор.
+     * @return Позиция или npos, если идентификатора нет.
+     */
+    size_t find(uint64_t id) const;
+
+    /**
+     * @brief Удаляет все элементы.
+     */
+    void clear();
+
+    /**
+     * @brief Заранее выделяет место под count элементов.
+     */
+    void reserve(size_t count);
+
+    size_t size() const { return count; }
+
+private:
+    /// Ячейка таблицы.
+    struct Entry {
+        uint64_t id = 0;
+        size_t slot = 0;
+    };
+
+    size_t home(uint64_t id) const;
+    void rehash(size_t capacity);
+
+    std::vector<Entry> entries; ///< Ячейки, размер — степень двойки.
+    size_t count = 0;           ///< Число занятых ячеек.
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @class MappedFile
+ * @brief Файл, отображённый в память только для чтения.
+ *
+ * На POSIX-системах используется mmap, на остальных файл целиком
+ * читается в буфер — интерфейс при этом одинаковый.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Отображает файл в память.
+     * @param path Путь к файлу.
+     * @return true, если файл открыт и отображён.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Освобождает отображение.
+     */
+    void close();
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes = nullptr; ///< Начало отображённых данных.
+    size_t length = 0;           ///< Размер файла в байтах.
+    bool mapped = false;         ///< Данные получены через mmap.
+    std::vector<char> buffer;    ///< Запасной буфер, если mmap недоступен.
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "Task.h"
+#include "TaskRange.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct PersistBatch
+ * @brief Пачка изменений, готовая к записи на диск без обращения к User.
+ *
+ * Содержит либо только записи журнала, либо полный снимок задач, за
+ * которым могут следовать записи журнала с бóльшими номерами. Пачку можно
+ * записать в любом потоке.
+ */
+struct PersistBatch {
+    std::string log_path;       ///< Путь к журналу изменений.
+    std::string snapshot_path;  ///< Путь к двоичному снимку.
+    std::string records;        ///< Записи журнала, по одной на строку.
+    size_t record_count = 0;    ///< Количество записей в records.
+    bool snapshot = false;      ///< Перед записями нужно записать снимок.
+    TaskTable tasks;            ///< Снимок холодной таблицы TaskStore (с надгробиями), общий с User.
+    size_t task_count = 0;      ///< Количество живых задач в снимке.
+    TagDictionary tags;         ///< Словарь тегов для снимка.
+    uint64_t seq = 0;           ///< Номер последней записи, учтённой в снимке.
+
+    /**
+     * @brief Проверяет, есть ли что записывать.
+     */
+    bool empty() const { return !snapshot && record_count == 0; }
+
+    /**
+     * @brief Присоединяет более позднюю пачку к этой.
+     *
+     * Новый снимок полностью заменяет всё накопленное, записи журнала
+     * дописываются в конец.
+     * @param next Пачка, сформированная после текущей.
+     */
+    void merge(PersistBatch&& next);
+
+    /**
+     * @brief Записывает пачку: снимок (атомарно), затем записи журнала.
+     * @return true при успешной записи.
+     */
+    bool write() const;
+};
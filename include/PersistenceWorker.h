@@ -0,0 +1,84 @@
+#pragma once
+#include "PersistBatch.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class PersistenceWorker
+ * @brief Фоновый поток сохранения задач.
+ *
+ * Интерфейс передаёт сюда пачки изменений (User::take_changes()) и сразу
+ * продолжает отрисовку. Поток ждёт паузы в правках (debounce), склеивает
+ * накопившиеся пачки в одну и записывает её. Результаты записи забираются
+ * из потока интерфейса через poll().
+ *
+ * После неудачной записи в конце журнала может остаться оборванная строка,
+ * и дописанные за ней записи при загрузке уже не прочитаются. Поэтому до
+ * первого удачного снимка пачки без снимка не пишутся, а отчитываются
+ * ошибкой: интерфейс должен запросить снимок (User::request_snapshot()).
+ */
+class PersistenceWorker {
+public:
+    /// Итог одной записи на диск.
+    struct Result {
+        bool ok = true;       ///< Запись прошла успешно.
+        std::string message;  ///< Описание ошибки, если запись не удалась.
+    };
+
+    /**
+     * @brief Запускает фоновый поток.
+     * @param debounce Пауза после последней правки перед записью.
+     * @param max_delay Предельная задержка записи при непрерывных правках.
+     */
+    explicit PersistenceWorker(std::chrono::milliseconds debounce = std::chrono::milliseconds(300),
+                               std::chrono::milliseconds max_delay = std::chrono::milliseconds(2000));
+
+    /**
+     * @brief Дописывает оставшиеся изменения и останавливает поток.
+     */
+    ~PersistenceWorker();
+
+    PersistenceWorker(const PersistenceWorker&) = delete;
+    PersistenceWorker& operator=(const PersistenceWorker&) = delete;
+
+    /**
+     * @brief Ставит пачку изменений в очередь на запись.
+     * @param batch Пачка изменений.
+     */
+    void submit(PersistBatch batch);
+
+    /**
+     * @brief Немедленно записывает очередь и ждёт завершения записи.
+     */
+    void flush();
+
+    /**
+     * @brief Забирает результаты завершённых записей.
+     * @return Результаты в порядке записи.
+     */
+    std::vector<Result> poll();
+
+private:
+    void run();
+
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::milliseconds debounce;   ///< Пауза перед записью.
+    std::chrono::milliseconds max_delay;  ///< Предельная задержка записи.
+    std::mutex mutex;
+    std::condition_variable wake;         ///< Новая пачка, flush или остановка.
+    std::condition_variable idle;         ///< Очередь записана.
+    PersistBatch queued;                  ///< Склеенные пачки, ожидающие записи.
+    Clock::time_point first_submit;       ///< Когда в пустую очередь пришла пачка.
+    Clock::time_point last_submit;        ///< Когда пришла последняя пачка.
+    bool writing = false;                 ///< Поток сейчас пишет на диск.
+    bool flushing = false;                ///< Запрошена немедленная запись.
+    bool stopping = false;                ///< Поток должен завершиться.
+    bool log_broken = false;              ///< Запись не удалась; до снимка журнал не дописывается.
+    std::vector<Result> results;          ///< Результаты для poll().
+    std::thread worker;                   ///< Фоновый поток записи.
+};
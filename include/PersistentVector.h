@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @class PersistentVector
+ * @brief Вектор со структурным разделением: дерево с ветвлением 32 и копированием пути.
+ *
+ * Копия вектора — снимок за O(1): копируется только указатель на корень.
+ * Изменение элемента копирует лишь узлы на пути от корня к листу
+ * (O(log32 n), для миллиона элементов — 4 узла), остальное дерево остаётся
+ * общим со снимками. Узел, которым больше никто не владеет, меняется на
+ * месте, поэтому без снимков вектор не копирует ничего.
+ *
+ * Узлы неизменяемы, пока ими владеет больше одного вектора, а счётчики
+ * ссылок std::shared_ptr атомарны, поэтому снимок можно читать из другого
+ * потока, пока владелец продолжает менять свою копию. use_count() читается
+ * без упорядочивания, поэтому перед правкой узла на месте стоит acquire-барьер:
+ * чтения снимка в другом потоке, отпустившего узел, завершатся раньше записи.
+ */
+template <typename T>
+class PersistentVector {
+    static constexpr unsigned kBits = 5;
+    static constexpr size_t kWidth = size_t(1) << kBits;
+    static constexpr size_t kMask = kWidth - 1;
+
+    /// Узел дерева: внутренний хранит детей, лист — значения.
+    struct Node {
+        std::vector<std::shared_ptr<Node>> children;
+        std::vector<T> values;
+    };
+
+public:
+    /// Итератор по элементам в порядке индексов.
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const PersistentVector* owner, size_t index)
+            : owner(owner), index(index), leaf(index < owner->count ? owner->leaf(index) : nullptr) {}
+
+        reference operator*() const { return leaf[index & kMask]; }
+        pointer operator->() const { return &leaf[index & kMask]; }
+
+        const_iterator& operator++() {
+            // Лист меняется раз в 32 элемента.
+            if ((++index & kMask) == 0 && index < owner->count) leaf = owner->leaf(index);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        const PersistentVector* owner; ///< Вектор.
+        size_t index;                  ///< Текущий индекс.
+        const T* leaf;                 ///< Значения текущего листа.
+    };
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const T& operator[](size_t i) const { return leaf(i)[i & kMask]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+    /**
+     * @brief Заменяет элемент, копируя общие со снимками узлы пути.
+     * @param i Индекс (меньше size()).
+     * @param value Новое значение.
+     */
+    void set(size_t i, T value) { unique_leaf(i)->values[i & kMask] = std::move(value); }
+
+    /**
+     * @brief Забирает элемент: переносит его, если путь ни с кем не общий, иначе копирует.
+     *
+     * Для перестройки вектора; элемент на месте остаётся в неопределённом состоянии.
+     * @param i Индекс.
+     */
+    T take(size_t i) {
+        Node* node = root.get();
+        bool shared = root.use_count() != 1;
+        for (unsigned level = shift; level > 0; level -= kBits) {
+            const std::shared_ptr<Node>& child = node->children[(i >> level) & kMask];
+            shared = shared || child.use_count() != 1;
+            node = child.get();
+        }
+        T& value = node->values[i & kMask];
+        if (shared) return T(value);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return std::move(value);
+    }
+
+    /**
+     * @brief Добавляет элемент в конец.
+     * @param value Значение.
+     */
+    void push_back(T value) {
+        if (!root) {
+            root = make_leaf();
+            shift = 0;
+        } else if (count == (size_t(1) << (shift + kBits))) {
+            // Дерево заполнено — над ним появляется новый корень.
+            auto top = std::make_shared<Node>();
+            top->children.reserve(kWidth);
+            top->children.push_back(std::move(root));
+            root = std::move(top);
+            shift += kBits;
+        }
+        Node* node = unshare(root);
+        for (unsigned level = shift; level > 0; level -= kBits) {
+            const size_t slot = (count >> level) & kMask;
+            if (slot == node->children.size()) node->children.push_back(level == kBits ? make_leaf() : make_inner());
+            node = unshare(node->children[slot]);
+        }
+        node->values.push_back(std::move(value));
+        ++count;
+    }
+
+    /**
+     * @brief Заменяет содержимое n копиями значения.
+     *
+     * Дерево строится снизу вверх целыми узлами, без n проходов push_back().
+     * @param n Количество элементов.
+     * @param value Значение.
+     */
+    void assign(size_t n, const T& value) {
+        clear();
+        if (n == 0) return;
+        std::vector<std::shared_ptr<Node>> level;
+        level.reserve((n + kMask) / kWidth);
+        for (size_t i = 0; i < n; i += kWidth) {
+            auto node = make_leaf();
+            node->values.assign(std::min(kWidth, n - i), value);
+            level.push_back(std::move(node));
+        }
+        while (level.size() > 1) {
+            std::vector<std::shared_ptr<Node>> parents;
+            parents.reserve((level.size() + kMask) / kWidth);
+            for (size_t i = 0; i < level.size(); i += kWidth) {
+                auto node = make_inner();
+                const size_t last = std::min(i + kWidth, level.size());
+                for (size_t k = i; k < last; ++k) node->children.push_back(std::move(level[k]));
+                parents.push_back(std::move(node));
+            }
+            level = std::move(parents);
+            shift += kBits;
+        }
+        root = std::move(level.front());
+        count = n;
+    }
+
+    void clear() {
+        root.reset();
+        count = 0;
+        shift = 0;
+    }
+
+    /**
+     * @brief Байты всех узлов вектора вместе с элементами.
+     *
+     * Общие с другими копиями узлы тоже считаются: когда копии исчезнут,
+     * их памятью будет владеть только этот вектор.
+     * @param element_bytes Динамическая память элемента сверх sizeof(T).
+     */
+    template <typename F>
+    size_t memory_bytes(F&& element_bytes) const {
+        return root ? node_bytes(*root, element_bytes) : 0;
+    }
+
+private:
+    static std::shared_ptr<Node> make_leaf() {
+        auto node = std::make_shared<Node>();
+        node->values.reserve(kWidth);
+        return node;
+    }
+
+    static std::shared_ptr<Node> make_inner() {
+        auto node = std::make_shared<Node>();
+        node->children.reserve(kWidth);
+        return node;
+    }
+
+    /// Узел, принадлежащий только этому вектору: общий копируется.
+    static Node* unshare(std::shared_ptr<Node>& node) {
+        if (node.use_count() != 1) {
+            auto copy = std::make_shared<Node>(*node);
+            copy->children.reserve(kWidth);
+            copy->values.reserve(node->values.empty() ? 0 : kWidth);
+            node = std::move(copy);
+        } else {
+            // Последний снимок мог только что отпустить узел в другом потоке.
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return node.get();
+    }
+
+    template <typename F>
+    static size_t node_bytes(const Node& node, F& element_bytes) {
+        size_t bytes = sizeof(Node) + node.children.capacity() * sizeof(std::shared_ptr<Node>) +
+                       node.values.capacity() * sizeof(T);
+        for (const auto& child : node.children) bytes += node_bytes(*child, element_bytes);
+        for (const T& value : node.values) bytes += element_bytes(value);
+        return bytes;
+    }
+
+    /// Лист с элементом i только для этого вектора.
+    Node* unique_leaf(size_t i) {
+        Node* node = unshare(root);
+        for (unsigned level = shift; level > 0; level -= kBits) node = unshare(node->children[(i >> level) & kMask]);
+        return node;
+    }
+
+    /// Значения листа с элементом i.
+    const T* leaf(size_t i) const {
+        const Node* node = root.get();
+        for (unsigned level = shift; level > 0; level -= kBits) node = node->children[(i >> level) & kMask].get();
+        return node->values.data();
+    }
+
+    std::shared_ptr<Node> root; ///< Корень; пусто для пустого вектора.
+    size_t count = 0;           ///< Количество элементов.
+    unsigned shift = 0;         ///< Сдвиг индекса на уровне корня.
+};
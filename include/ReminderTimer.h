@@ -0,0 +1,36 @@
+#pragma once
+#include "Deadline.h"
+
+/**
+ * @class ReminderTimer
+ * @brief Будильник на абсолютный момент для колеса напоминаний.
+ *
+ * На Linux это timerfd на CLOCK_REALTIME: ядро само отслеживает время, а
+ * цикл отрисовки лишь неблокирующе проверяет дескриптор. На других
+ * системах (и если timerfd недоступен) момент сравнивается с текущим
+ * временем.
+ */
+class ReminderTimer {
+public:
+    ReminderTimer();
+    ~ReminderTimer();
+
+    ReminderTimer(const ReminderTimer&) = delete;
+    ReminderTimer& operator=(const ReminderTimer&) = delete;
+
+    /**
+     * @brief Заводит будильник на момент at (прежний сбрасывается).
+     * @param at Момент в секундах от эпохи Unix.
+     */
+    void arm(DeadlineTime at);
+
+    /**
+     * @brief Проверяет, сработал ли будильник; сработавший сбрасывается.
+     * @param now Текущий момент (для систем без timerfd).
+     */
+    bool expired(DeadlineTime now);
+
+private:
+    int fd = -1;                    ///< Дескриптор timerfd или -1.
+    DeadlineTime armed = kNoDeadline; ///< Момент срабатывания, kNoDeadline — не заведён.
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include "Deadline.h"
+#include "Task.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @enum ReminderKind
+ * @brief Вид напоминания о дедлайне.
+ */
+enum class ReminderKind : uint8_t {
+    DueSoon, ///< До дедлайна осталось 24 часа.
+    Overdue  ///< Дедлайн наступил.
+};
+
+/**
+ * @struct Reminder
+ * @brief Сработавшее напоминание.
+ */
+struct Reminder {
+    TaskId id = 0;                          ///< Задача.
+    ReminderKind kind = ReminderKind::DueSoon; ///< Вид напоминания.
+    DeadlineTime at = 0;                    ///< Момент, на который оно назначено.
+};
+
+/**
+ * @class ReminderWheel
+ * @brief Иерархическое колесо таймеров для напоминаний о дедлайнах.
+ *
+ * Время идёт тиками по минуте. Колесо минут (60 ячеек) хранит таймеры на
+ * ближайший час, колесо часов (24 ячейки) — на ближайшие сутки, колесо дней
+ * (366 ячеек) — на ближайший год, более дальние лежат в общем списке.
+ * Когда колесо минут проходит полный круг, ячейка следующего часа
+ * переносится в него, и так же часы получают таймеры из колеса дней. Каждый
+ * таймер переносится не больше трёх раз, поэтому постановка и срабатывание
+ * стоят O(1) в среднем на задачу — без обхода всех задач на каждом тике.
+ *
+ * Отмена ленивая: у задачи есть номер поколения, и таймеры старого
+ * поколения при срабатывании пропускаются.
+ */
+class ReminderWheel {
+public:
+    /// Длина тика в секундах.
+    static constexpr DeadlineTime kTick = 60;
+
+    /**
+     * @brief Создаёт колесо, начинающее отсчёт с момента now.
+     * @param now Текущий момент.
+     */
+    explicit ReminderWheel(DeadlineTime now = 0);
+
+    /**
+     * @brief Назначает напоминания задачи, заменяя прежние.
+     *
+     * Напоминания, момент которых уже прошёл, не назначаются: колесо
+     * сообщает о переходах, случившихся, пока приложение работает.
+     * @param id Задача.
+     * @param due Разобранный дедлайн; kNoDeadline отменяет напоминания.
+     */
+    void schedule(TaskId id, DeadlineTime due);
+
+    /// Отменяет напоминания задачи.
+    void cancel(TaskId id);
+
+    /**
+     * @brief Продвигает время и возвращает сработавшие напоминания.
+     * @param now Текущий момент.
+     * @return Напоминания в порядке срабатывания.
+     */
+    std::vector<Reminder> advance(DeadlineTime now);
+
+    /// Момент начала следующего тика (для будильника).
+    DeadlineTime next_tick() const { return (tick + 1) * kTick; }
+
+    /// Число назначенных и ещё не сработавших напоминаний.
+    size_t pending() const { return live; }
+
+private:
+    /// Назначенное напоминание.
+    struct Timer {
+        int64_t expires;     ///< Тик срабатывания.
+        uint64_t generation; ///< Поколение задачи на момент постановки.
+        Reminder reminder;   ///< Что сообщить.
+    };
+
+    /// Текущее поколение таймеров задачи и число её живых таймеров.
+    struct Owner {
+        uint64_t generation;
+        uint32_t live;
+    };
+
+    void place(Timer timer);
+    void cascade(std::vector<Timer>& slot);
+    void step(std::vector<Reminder>& fired);
+    bool alive(const Timer& timer) const;
+
+    std::array<std::vector<Timer>, 60> minutes;  ///< Таймеры ближайшего часа.
+    std::array<std::vector<Timer>, 24> hours;    ///< Таймеры ближайших суток.
+    std::array<std::vector<Timer>, 366> days;    ///< Таймеры ближайшего года.
+    std::vector<Timer> overflow;                 ///< Таймеры дальше года.
+    std::unordered_map<TaskId, Owner> owners;    ///< Задача → поколение её таймеров.
+    int64_t tick;                                ///< Текущий тик.
+    uint64_t next_generation = 1;                ///< Следующий номер поколения.
+    size_t live = 0;                             ///< Число живых таймеров.
+};
@@ -0,0 +1,171 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @class RoaringBitmap
+ * @brief Сжатое множество 32-битных чисел в духе Roaring.
+ *
+ * Числа делятся на блоки по старшим 16 битам. Разреженный блок хранится
+ * отсортированным массивом младших половин (до 4096 элементов), плотный —
+ * битовой картой на 65536 бит. Пересечение, объединение и разность идут
+ * поблочно: над двумя битовыми картами — по 64 бита за операцию.
+ */
+class RoaringBitmap {
+public:
+    /**
+     * @brief Добавляет число.
+     * @return true, если числа ещё не было.
+     */
+    bool add(uint32_t value);
+
+    /**
+     * @brief Добавляет число, большее всех имеющихся, без поиска блока.
+     *
+     * Для построения множества по возрастанию (например, при загрузке);
+     * число не больше максимума добавляется обычным add().
+     */
+    void append(uint32_t value);
+
+    /**
+     * @brief Множество по простой битовой строке: число i есть, если взведён бит i.
+     *
+     * Блоки собираются целиком (массивом или битовой картой по плотности) —
+     * для плотных множеств быстрее, чем добавлять числа по одному.
+     * @param words Слова битовой строки, бит i — в слове i / 64.
+     */
+    static RoaringBitmap from_words(const std::vector<uint64_t>& words);
+
+    /**
+     * @brief Удаляет число.
+     * @return true, если число было.
+     */
+    bool remove(uint32_t value);
+
+    bool contains(uint32_t value) const;
+
+    /// Количество чисел во множестве.
+    uint64_t cardinality() const;
+
+    bool empty() const { return containers.empty(); }
+    void clear() { containers.clear(); }
+
+    RoaringBitmap& operator&=(const RoaringBitmap& other);
+    RoaringBitmap& operator|=(const RoaringBitmap& other);
+    /// Разность множеств (AND NOT).
+    RoaringBitmap& operator-=(const RoaringBitmap& other);
+
+    friend RoaringBitmap operator&(RoaringBitmap a, const RoaringBitmap& b) { return a &= b; }
+    friend RoaringBitmap operator|(RoaringBitmap a, const RoaringBitmap& b) { return a |= b; }
+    friend RoaringBitmap operator-(RoaringBitmap a, const RoaringBitmap& b) { return a -= b; }
+
+    bool operator==(const RoaringBitmap& other) const;
+    bool operator!=(const RoaringBitmap& other) const { return !(*this == other); }
+
+    /**
+     * @brief Вызывает f(value) для каждого числа по возрастанию.
+     */
+    template <typename F>
+    void for_each(F&& f) const {
+        for (const Container& c : containers) {
+            const uint32_t high = static_cast<uint32_t>(c.key) << 16;
+            if (c.is_bitmap()) {
+                for (size_t w = 0; w < c.bits.size(); ++w) {
+                    uint64_t word = c.bits[w];
+                    while (word != 0) {
+                        uint32_t bit = trailing_zeros(word);
+                        f(high | static_cast<uint32_t>(w * 64 + bit));
+                        word &= word - 1;
+                    }
+                }
+            } else {
+                for (uint16_t low : c.array) f(high | low);
+            }
+        }
+    }
+
+    /// Все числа по возрастанию.
+    std::vector<uint32_t> to_vector() const;
+
+    /// Итератор по числам множества в порядке возрастания.
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const uint32_t*;
+        using reference = uint32_t;
+
+        const_iterator(const RoaringBitmap* owner, size_t container) : owner(owner), container(container) {
+            start();
+        }
+
+        uint32_t operator*() const;
+        const_iterator& operator++();
+
+        bool operator==(const const_iterator& other) const {
+            return container == other.container && pos == other.pos && word == other.word;
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        void start();
+
+        const RoaringBitmap* owner; ///< Множество.
+        size_t container;           ///< Номер текущего блока.
+        size_t pos = 0;             ///< Индекс в массиве или номер слова битовой карты.
+        uint64_t word = 0;          ///< Ещё не пройденные биты текущего слова.
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, containers.size()); }
+
+private:
+    /// Блок чисел с общими старшими 16 битами.
+    struct Container {
+        uint16_t key = 0;             ///< Старшие 16 бит.
+        uint32_t cardinality = 0;     ///< Количество чисел в блоке.
+        std::vector<uint16_t> array;  ///< Младшие половины по возрастанию (разреженный блок).
+        std::vector<uint64_t> bits;   ///< Битовая карта (плотный блок), иначе пусто.
+
+        bool is_bitmap() const { return !bits.empty(); }
+        bool contains(uint16_t low) const;
+        void to_bitmap();
+        void to_array();
+        void normalize();
+    };
+
+    static uint32_t trailing_zeros(uint64_t word);
+    static uint32_t popcount(uint64_t word);
+
+    size_t lower_bound(uint16_t key) const;
+
+    static void intersect(Container& a, const Container& b);
+    static void unite(Container& a, const Container& b);
+    static void subtract(Container& a, const Container& b);
+
+    std::vector<Container> containers; ///< Непустые блоки по возрастанию ключа.
+};
+
+inline uint32_t RoaringBitmap::trailing_zeros(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(word));
+#endif
+}
+
+inline uint32_t RoaringBitmap::popcount(uint64_t word) {
+#ifdef _MSC_VER
+    return static_cast<uint32_t>(__popcnt64(word));
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(word));
+#endif
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Идентификатор тега в словаре пользователя.
+using TagId = uint32_t;
+
+/**
+ * @class TagDictionary
+ * @brief Словарь тегов: каждое различное имя хранится один раз и получает
+ * небольшой целочисленный идентификатор.
+ *
+ * Задачи хранят списки идентификаторов, поэтому сравнение тегов — сравнение
+ * чисел, а переименование тега во всех задачах сразу — одна замена имени
+ * в словаре. Идентификаторы не переиспользуются: неиспользуемые имена
+ * остаются в словаре до следующей загрузки.
+ */
+class TagDictionary {
+public:
+    static constexpr TagId npos = std::numeric_limits<TagId>::max();
+
+    /**
+     * @brief Возвращает идентификатор тега, при необходимости добавляя его.
+     * @param name Имя тега.
+     */
+    TagId intern(const std::string& name);
+
+    /**
+     * @brief Ищет тег по имени.
+     * @param name Имя тега.
+     * @return Идентификатор или npos, если такого тега нет.
+     */
+    TagId find(const std::string& name) const;
+
+    /**
+     * @brief Имя тега по идентификатору.
+     */
+    const std::string& name(TagId id) const { return names_[id]; }
+
+    /**
+     * @brief Имена тегов по списку идентификаторов.
+     */
+    std::vector<std::string> names(const std::vector<TagId>& ids) const;
+
+    /**
+     * @brief Переименовывает тег; идентификатор сохраняется.
+     * @param from Текущее имя.
+     * @param to Новое имя.
+     * @return false, если тега from нет или имя to уже занято.
+     */
+    bool rename(const std::string& from, const std::string& to);
+
+    /// Количество имён в словаре.
+    size_t size() const { return names_.size(); }
+
+    void clear();
+
+private:
+    std::vector<std::string> names_;             ///< Имена по идентификатору.
+    std::unordered_map<std::string, TagId> ids_; ///< Имя → идентификатор.
+};
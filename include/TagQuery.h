@@ -0,0 +1,52 @@
+#pragma once
+#include "TagDictionary.h"
+#include "TaskStore.h"
+#include "RoaringBitmap.h"
+#include <string>
+#include <vector>
+
+/**
+ * @class TagQuery
+ * @brief Логическое выражение над тегами, например `work AND urgent AND NOT blocked`.
+ *
+ * Операции: NOT (наивысший приоритет), AND, OR; допускаются скобки. Имя тега —
+ * слово без пробелов и скобок или строка в двойных кавычках. Ключевые слова
+ * пишутся заглавными буквами, так что тег «and» остаётся тегом. Выражение
+ * вычисляется пересечениями и объединениями множеств позиций из TaskStore.
+ */
+class TagQuery {
+public:
+    /**
+     * @brief Разбирает выражение.
+     * @param text Текст выражения.
+     * @param out Разобранный запрос.
+     * @param error Описание ошибки.
+     * @return false, если выражение некорректно.
+     */
+    static bool parse(const std::string& text, TagQuery& out, std::string& error);
+
+    /**
+     * @brief Вычисляет множество позиций задач, удовлетворяющих выражению.
+     * @param store Хранилище задач.
+     * @param dictionary Словарь тегов; неизвестный тег не совпадает ни с одной задачей.
+     */
+    RoaringBitmap evaluate(const TaskStore& store, const TagDictionary& dictionary) const;
+
+    /// Пустое выражение — подходит любая задача.
+    bool empty() const { return nodes.empty(); }
+
+private:
+    /// Узел дерева выражения.
+    struct Node {
+        enum class Kind { Tag, And, Or, Not } kind;
+        std::string tag; ///< Имя тега (для Kind::Tag).
+        int left = -1;   ///< Левый операнд или единственный операнд NOT.
+        int right = -1;  ///< Правый операнд.
+    };
+
+    class Parser;
+
+    RoaringBitmap eval(int node, const TaskStore& store, const TagDictionary& dictionary) const;
+
+    std::vector<Node> nodes; ///< Узлы; корень — последний.
+};
@@ -1,19 +1,121 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
+#include <nlohmann/json.hpp>
+#include "Deadline.h"
+#include "TagDictionary.h"
 
-enum class Priority { Low, Medium, High };
-enum class Status { Active, Done };
+using json = nlohmann::json;
 
+/// Постоянный идентификатор задачи; 0 — «нет задачи».
+using TaskId = uint64_t;
+
+/**
+ * @enum Priority
+ * @brief Перечисление уровней приоритета задачи.
+ */
+enum class Priority : uint8_t { Low, Medium, High };
+
+/**
+ * @enum Status
+ * @brief Перечисление состояний выполнения задачи.
+ */
+enum class Status : uint8_t { Active, Done };
+
+/**
+ * @brief Преобразует перечисление Priority в строку.
+ * @param p Приоритет.
+ * @return Строка, соответствующая приоритету.
+ */
+std::string priorityToString(Priority p);
+
+/**
+ * @brief Преобразует перечисление Status в строку.
+ * @param s Статус.
+ * @return Строка, соответствующая статусу.
+ */
+std::string statusToString(Status s);
+
+/**
+ * @brief Преобразует строку в соответствующее значение перечисления Priority.
+ * @param str Строка "Low", "Medium", или "High".
+ * @return Значение Priority.
+ */
+Priority stringToPriority(const std::string& str);
+
+/**
+ * @brief Преобразует строку в соответствующее значение перечисления Status.
+ * @param str Строка "Active" или "Done".
+ * @return Значение Status.
+ */
+Status stringToStatus(const std::string& str);
+
+/**
+ * @struct Task
+ * @brief Структура, описывающая одну задачу.
+ */
 struct Task {
+    TaskId id = 0; ///< Уникальный в пределах пользователя, назначается User::add_task.
     std::string title;
     std::string description;
-    Priority priority;
-    Status status;
-    std::string deadline;
-    std::vector<std::string> tags;
+    Priority priority = Priority::Low;
+    Status status = Status::Active;
+    std::string deadline;           ///< Дедлайн как его ввёл пользователь ("YYYY-MM-DD HH:MM").
+    DeadlineTime due = kNoDeadline; ///< Разобранный дедлайн; kNoDeadline — пусто или не распознан.
+    std::vector<TagId> tags; ///< Идентификаторы тегов в словаре пользователя.
+
+    Task() = default;
 
     Task(const std::string& t, const std::string& d, Priority p, Status s,
-         const std::string& dl, const std::vector<std::string>& tg)
-        : title(t), description(d), priority(p), status(s), deadline(dl), tags(tg) {}
+         const std::string& dl, const std::vector<TagId>& tg)
+        : title(t), description(d), priority(p), status(s), deadline(dl), due(parse_deadline(dl)), tags(tg) {}
+
+    /**
+     * @brief Задаёт дедлайн строкой и сразу разбирает его.
+     *
+     * Строка разбирается только здесь: проверки просрочки, сортировка и
+     * календарь работают с полем due.
+     * @param text Строка дедлайна.
+     */
+    void set_deadline(std::string text) {
+        deadline = std::move(text);
+        due = parse_deadline(deadline);
+    }
+
+    /// Дедлайн введён, но не распознан.
+    bool deadline_invalid() const { return due == kNoDeadline && !deadline.empty(); }
+
+    /**
+     * @brief Преобразует задачу в JSON-объект.
+     * @param dictionary Словарь, по которому теги записываются именами.
+     * @return json, описывающий текущую задачу.
+     */
+    json to_json(const TagDictionary& dictionary) const;
+
+    /**
+     * @brief Загружает задачу из JSON-объекта.
+     * @param j json-объект.
+     * @param dictionary Словарь, в который добавляются имена тегов.
+     * @return Task, инициализированный данными из JSON.
+     */
+    static Task from_json(const json& j, TagDictionary& dictionary);
 };
+
+/**
+ * @brief Неизменяемая задача с подсчётом ссылок.
+ *
+ * Хранилище, снимки, история отмены и результаты поиска делят одну и ту же
+ * задачу: копия ручки — это копия указателя. Правка не меняет задачу,
+ * а создаёт новую (копирование при записи), поэтому все, кто держит
+ * старую ручку, продолжают видеть прежнее значение.
+ */
+using TaskHandle = std::shared_ptr<const Task>;
+
+/**
+ * @brief Создаёт ручку, забирая содержимое задачи.
+ * @param task Задача.
+ */
+inline TaskHandle make_task_handle(Task task) { return std::make_shared<const Task>(std::move(task)); }
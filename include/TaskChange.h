@@ -0,0 +1,29 @@
+#pragma once
+#include "Task.h"
+#include "TaskRange.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct TaskChange
+ * @brief Обратимая операция над задачами для отката и повтора.
+ *
+ * Описывает, что нужно сделать, чтобы отменить изменение. После
+ * выполнения (User::revert) превращается в операцию, отменяющую сам откат.
+ */
+struct TaskChange {
+    enum class Kind : uint8_t {
+        Remove,  ///< Удалить задачу id (отмена добавления).
+        Restore, ///< Вернуть удалённую задачу task на позицию slot.
+        Assign,  ///< Вернуть задаче прежнее значение task.
+        Reset,   ///< Заменить все задачи записями records (отмена импорта).
+        Batch    ///< Выполнить steps с конца (отмена пачки User::apply_batch).
+    };
+    Kind kind = Kind::Remove;
+    TaskId id = 0;                  ///< Задача, к которой относится операция.
+    TaskHandle task;  ///< Restore и Assign: значение задачи (общее с хранилищем и снимками).
+    size_t slot = 0;  ///< Restore: позиция задачи до удаления.
+    TaskTable records; ///< Reset: снимок содержимого целиком.
+    std::vector<TaskChange> steps; ///< Batch: операции отмены в порядке изменений.
+};
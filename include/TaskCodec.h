@@ -0,0 +1,67 @@
+#pragma once
+#include "Task.h"
+#include "TaskRange.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class TaskSaxLoader;
+
+/**
+ * @class TaskCodec
+ * @brief Формат файла задач для импорта и экспорта.
+ *
+ * Поддерживаются компактный JSON (`.json`), CBOR (`.cbor`) и MessagePack
+ * (`.msgpack`). Формат выбирается по расширению файла. Чтение во всех
+ * форматах идёт потоково через TaskSaxLoader, без построения JSON-дерева.
+ */
+class TaskCodec {
+public:
+    virtual ~TaskCodec() = default;
+
+    /**
+     * @brief Название формата.
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Расширение файла, включая точку.
+     */
+    virtual const char* extension() const = 0;
+
+    /**
+     * @brief Записывает задачи в поток.
+     * @param tasks Задачи.
+     * @param dictionary Словарь тегов задач.
+     * @param out Выходной поток (двоичный режим).
+     */
+    virtual void encode(const std::vector<Task>& tasks, const TagDictionary& dictionary,
+                        std::ostream& out) const = 0;
+
+    /**
+     * @brief Записывает живые задачи диапазона (например, TaskStore) без их копирования.
+     * @see encode(const std::vector<Task>&, const TagDictionary&, std::ostream&) const
+     */
+    virtual void encode(const TaskRange& tasks, const TagDictionary& dictionary,
+                        std::ostream& out) const = 0;
+
+    /**
+     * @brief Читает задачи из потока в загрузчик.
+     * @param in Входной поток (двоичный режим).
+     * @param loader Загрузчик, получающий задачи.
+     * @return true, если документ корректен.
+     */
+    virtual bool decode(std::istream& in, TaskSaxLoader& loader) const = 0;
+
+    /**
+     * @brief Подбирает формат по расширению файла.
+     * @param path Путь к файлу.
+     * @return Формат или nullptr, если расширение не поддерживается.
+     */
+    static const TaskCodec* for_path(const std::string& path);
+
+    /**
+     * @brief Все поддерживаемые форматы.
+     */
+    static const std::vector<const TaskCodec*>& all();
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include "Task.h"
+#include "TaskRange.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * @class TaskJsonWriter
+ * @brief Потоковая запись задач в компактный JSON без построения JSON-дерева.
+ *
+ * Результат побайтно совпадает с json::dump() для массива Task::to_json():
+ * ключи идут в алфавитном порядке, управляющие символы экранируются так же,
+ * как в nlohmann. Задачи экранируются прямо в большой выходной буфер, который
+ * сбрасывается в поток по заполнении, поэтому на задачу не тратится ни одного
+ * выделения памяти.
+ */
+class TaskJsonWriter {
+public:
+    /**
+     * @brief Создаёт писатель поверх потока.
+     * @param out Выходной поток.
+     * @param dictionary Словарь, по которому теги записываются именами.
+     * @param buffer_size Размер буфера, после заполнения которого данные сбрасываются в поток.
+     */
+    TaskJsonWriter(std::ostream& out, const TagDictionary& dictionary, size_t buffer_size = 1 << 20);
+
+    /**
+     * @brief Сбрасывает остаток буфера в поток.
+     */
+    ~TaskJsonWriter();
+
+    TaskJsonWriter(const TaskJsonWriter&) = delete;
+    TaskJsonWriter& operator=(const TaskJsonWriter&) = delete;
+
+    /**
+     * @brief Записывает массив задач целиком.
+     * @param tasks Задачи.
+     */
+    void write_array(const std::vector<Task>& tasks);
+
+    /**
+     * @brief Записывает массив живых задач диапазона (например, TaskStore) без их копирования.
+     * @param tasks Задачи.
+     */
+    void write_array(const TaskRange& tasks);
+
+    /**
+     * @brief Записывает одну задачу как JSON-объект.
+     * @param task Задача.
+     */
+    void write_task(const Task& task);
+
+    /**
+     * @brief Записывает символ разметки (например, '[', ',' или ']').
+     * @param c Символ.
+     */
+    void put(char c);
+
+    /**
+     * @brief Сбрасывает буфер в поток.
+     */
+    void flush();
+
+private:
+    template <typename Range>
+    void write_range(const Range& tasks);
+    void write_string(const std::string& s);
+    void write_number(uint64_t value);
+    void reserve_for(size_t bytes);
+
+    std::ostream& out;                ///< Выходной поток.
+    const TagDictionary& dictionary;  ///< Имена тегов.
+    std::string buffer;               ///< Выходной буфер.
+    size_t limit;                     ///< Порог сброса буфера.
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <functional>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/**
+ * @class TaskLog
+ * @brief Журнал изменений задач, открытый только на дозапись.
+ *
+ * Каждая запись — одна строка JSON (добавление, изменение или удаление
+ * задачи). Записи дописываются в конец файла и сбрасываются на диск через
+ * fsync, поэтому одна правка стоит O(размера записи), а не O(всех задач).
+ * Оборванная последняя строка (без '\n', сбой во время записи) при чтении
+ * отбрасывается; испорченная строка в любом другом месте — ошибка загрузки,
+ * и файл при этом не меняется.
+ */
+class TaskLog {
+public:
+    /**
+     * @brief Создаёт журнал, связанный с файлом.
+     * @param path Путь к файлу журнала.
+     */
+    explicit TaskLog(const std::string& path = "");
+
+    /**
+     * @brief Дописывает пачку записей в конец журнала и вызывает fsync.
+     * @param lines Записи, каждая завершается символом '\n'.
+     * @param count Количество записей в пачке.
+     * @return true при успешной записи.
+     */
+    bool append(const std::string& lines, size_t count);
+
+    /**
+     * @brief Последовательно передаёт все целые записи журнала в обработчик.
+     *
+     * Если строка (кроме оборванной последней) не разбирается или отвергнута
+     * обработчиком, бросает std::runtime_error с номером строки.
+     * @param apply Обработчик одной записи; false — запись не годится.
+     * @return Количество прочитанных записей.
+     */
+    size_t replay(const std::function<bool(const json&)>& apply);
+
+    /**
+     * @brief Очищает журнал (после записи снимка) и вызывает fsync.
+     * @return true, если очистка дошла до диска.
+     */
+    bool truncate();
+
+    /**
+     * @brief Возвращает количество записей в файле журнала.
+     */
+    size_t record_count() const { return records; }
+
+    /**
+     * @brief Возвращает путь к файлу журнала.
+     */
+    const std::string& file_path() const { return path; }
+
+private:
+    std::string path; ///< Путь к файлу журнала.
+    size_t records = 0; ///< Число записей, находящихся в файле.
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include "Task.h"
+#include <cstdint>
+#include <utility>
+
+/**
+ * @struct TaskOp
+ * @brief Одна операция пачки изменений для User::apply_batch.
+ */
+struct TaskOp {
+    enum class Kind : uint8_t {
+        Add,   ///< Добавить задачу task с новым идентификатором.
+        Edit,  ///< Заменить задачу id содержимым task.
+        Delete ///< Удалить задачу id.
+    };
+    Kind kind = Kind::Add;
+    TaskId id = 0; ///< Edit и Delete: идентификатор задачи.
+    Task task;     ///< Add и Edit: содержимое задачи.
+
+    static TaskOp add(Task task) { return TaskOp{Kind::Add, 0, std::move(task)}; }
+    static TaskOp edit(TaskId id, Task task) { return TaskOp{Kind::Edit, id, std::move(task)}; }
+    static TaskOp remove(TaskId id) { return TaskOp{Kind::Delete, id, Task()}; }
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include "Task.h"
+#include "PersistentVector.h"
+#include <cstddef>
+#include <iterator>
+
+/// Холодная таблица задач: ручки по позициям, пустая ручка — надгробие.
+using TaskTable = PersistentVector<TaskHandle>;
+
+/**
+ * @class TaskRange
+ * @brief Диапазон живых задач поверх хранилища с «надгробиями».
+ *
+ * Удалённая задача остаётся в хранилище пустой ручкой; итератор такие
+ * записи пропускает. Диапазон не владеет задачами и
+ * действителен до следующего изменения списка.
+ */
+class TaskRange {
+public:
+    /// Итератор по живым задачам.
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Task;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Task*;
+        using reference = const Task&;
+
+        using Cursor = TaskTable::const_iterator;
+
+        iterator(Cursor pos, Cursor last) : pos(pos), last(last) { skip(); }
+
+        reference operator*() const { return **pos; }
+        pointer operator->() const { return pos->get(); }
+
+        iterator& operator++() {
+            ++pos;
+            skip();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const iterator& other) const { return pos == other.pos; }
+        bool operator!=(const iterator& other) const { return pos != other.pos; }
+
+    private:
+        void skip() {
+            while (pos != last && !*pos) ++pos;
+        }
+
+        Cursor pos;  ///< Текущая запись.
+        Cursor last; ///< Конец хранилища.
+    };
+
+    /**
+     * @brief Создаёт диапазон.
+     * @param slots Хранилище задач вместе с надгробиями.
+     * @param live Количество живых задач.
+     */
+    TaskRange(const TaskTable& slots, size_t live) : slots(slots), live(live) {}
+
+    iterator begin() const { return iterator(slots.begin(), slots.end()); }
+    iterator end() const { return iterator(slots.end(), slots.end()); }
+
+    size_t size() const { return live; }
+    bool empty() const { return live == 0; }
+
+    /**
+     * @brief Последняя живая задача (диапазон не должен быть пустым).
+     */
+    const Task& back() const {
+        size_t i = slots.size();
+        while (!slots[i - 1]) --i;
+        return *slots[i - 1];
+    }
+
+private:
+    const TaskTable& slots; ///< Хранилище задач.
+    size_t live;            ///< Количество живых задач.
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include "Task.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class TaskSaxLoader
+ * @brief Потоковый загрузчик задач поверх nlohmann::json::sax_parse.
+ *
+ * Собирает объекты Task прямо по мере поступления лексем, не строя
+ * JSON-дерево. Понимает оба формата файла задач: голый массив задач и
+ * объект вида {"seq": N, "tasks": [...]}. Неизвестные ключи пропускаются.
+ */
+class TaskSaxLoader : public nlohmann::json_sax<json> {
+public:
+    /**
+     * @brief Создаёт загрузчик, дописывающий задачи в конец вектора.
+     * @param out Вектор, в который складываются задачи.
+     * @param dictionary Словарь, в который добавляются имена тегов.
+     */
+    TaskSaxLoader(std::vector<Task>& out, TagDictionary& dictionary);
+
+    /**
+     * @brief Разбирает поток и загружает задачи.
+     * @param in Входной поток.
+     * @param format Формат потока: JSON, CBOR или MessagePack.
+     * @return true, если документ корректен и все задачи полные.
+     */
+    bool load(std::istream& in, json::input_format_t format = json::input_format_t::json);
+
+    /**
+     * @brief Номер записи журнала из обёртки {"seq": ...}, иначе 0.
+     */
+    uint64_t seq() const { return seq_; }
+
+    /**
+     * @brief Текст последней ошибки разбора.
+     */
+    const std::string& error() const { return error_; }
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& last_token,
+                     const nlohmann::detail::exception& ex) override;
+
+private:
+    /// Поле задачи, к которому относится следующее значение.
+    enum class Field { Other, Title, Description, Priority, Status, Deadline, Tags, Id };
+
+    bool in_task() const { return inTask && depth == arrayDepth + 1; }
+    bool in_tags() const { return inTask && field == Field::Tags && depth == arrayDepth + 2; }
+
+    std::vector<Task>& tasks;  ///< Куда складываются готовые задачи.
+    TagDictionary& dictionary; ///< Словарь тегов.
+    Task current;              ///< Задача, которая сейчас собирается.
+    Field field = Field::Other; ///< Текущее поле задачи.
+    unsigned seen = 0;         ///< Битовая маска встреченных полей.
+    bool inTask = false;       ///< Разбирается объект задачи.
+    bool wrapped = false;      ///< Корень — объект {"seq", "tasks"}.
+    int depth = 0;             ///< Текущая глубина вложенности.
+    int arrayDepth = -1;       ///< Глубина массива задач.
+    std::string rootKey;       ///< Последний ключ корневого объекта.
+    uint64_t seq_ = 0;         ///< Номер записи журнала из обёртки.
+    std::string error_;        ///< Описание ошибки.
+};
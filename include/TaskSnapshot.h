@@ -0,0 +1,134 @@
+#pragma once
+#include "Task.h"
+#include "MappedFile.h"
+#include "TaskRange.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class TaskSnapshot
+ * @brief Двоичный снимок задач, читаемый прямо из отображённого файла.
+ *
+ * Формат (версия 3, порядок байт хоста):
+ * - заголовок фиксированного размера (сигнатура, версия, номер записи журнала, счётчики);
+ * - таблица задач: по одной записи фиксированного размера со смещениями строк;
+ * - таблица имён тегов (словарь, каждое имя один раз);
+ * - номера тегов задач в таблице имён (uint32);
+ * - куча строк.
+ *
+ * Поля задачи доступны как std::string_view без разбора и копирования.
+ */
+class TaskSnapshot {
+public:
+    /**
+     * @brief Записывает снимок атомарно: во временный файл с последующим переименованием.
+     *
+     * Временный файл сбрасывается на диск (fsync) до переименования, каталог —
+     * после, поэтому при true снимок переживёт сбой питания.
+     * @param path Путь к файлу снимка.
+     * @param tasks Задачи для записи.
+     * @param dictionary Словарь тегов задач; в снимок попадают только используемые имена.
+     * @param seq Номер последней записи журнала, учтённой в снимке.
+     * @return true при успешной записи.
+     */
+    static bool write(const std::string& path, const std::vector<Task>& tasks,
+                      const TagDictionary& dictionary, uint64_t seq);
+
+    /**
+     * @brief Записывает снимок живых задач диапазона (например, снимка TaskStore).
+     * @see write(const std::string&, const std::vector<Task>&, const TagDictionary&, uint64_t)
+     */
+    static bool write(const std::string& path, const TaskRange& tasks,
+                      const TagDictionary& dictionary, uint64_t seq);
+
+    /**
+     * @brief Отображает файл снимка в память и проверяет его структуру.
+     * @param path Путь к файлу снимка.
+     * @return true, если снимок корректен.
+     */
+    bool open(const std::string& path);
+
+    size_t size() const;
+    uint64_t seq() const;
+
+    TaskId id(size_t i) const;
+    std::string_view title(size_t i) const;
+    std::string_view description(size_t i) const;
+    std::string_view deadline(size_t i) const;
+    Priority priority(size_t i) const;
+    Status status(size_t i) const;
+    size_t tag_count(size_t i) const;
+    std::string_view tag(size_t i, size_t k) const;
+
+    /// Номер k-го тега задачи i в таблице имён (индекс в результате intern_names()).
+    uint32_t tag_index(size_t i, size_t k) const;
+
+    /// Количество имён в таблице тегов снимка.
+    size_t name_count() const;
+    std::string_view name(size_t n) const;
+
+    /**
+     * @brief Добавляет имена тегов снимка в словарь.
+     * @param dictionary Словарь пользователя.
+     * @return Идентификатор в словаре для каждого имени снимка (для task()).
+     */
+    std::vector<TagId> intern_names(TagDictionary& dictionary) const;
+
+    /**
+     * @brief Собирает объект Task из записи снимка.
+     * @param i Номер задачи.
+     * @param tag_ids Результат intern_names().
+     */
+    Task task(size_t i, const std::vector<TagId>& tag_ids) const;
+
+    /// Заголовок файла снимка.
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t seq;
+        uint64_t task_count;
+        uint64_t name_count;
+        uint64_t tag_count;
+        uint64_t heap_size;
+    };
+
+    /// Запись о задаче: смещения строк в куче и диапазон номеров её тегов.
+    struct Record {
+        uint64_t id;
+        uint64_t title;
+        uint64_t description;
+        uint64_t deadline;
+        uint64_t first_tag;
+        uint32_t title_len;
+        uint32_t description_len;
+        uint32_t deadline_len;
+        uint32_t tag_count;
+        uint8_t priority;
+        uint8_t status;
+        uint8_t reserved[6];
+    };
+
+    /// Ссылка на имя тега в куче.
+    struct TagRef {
+        uint64_t offset;
+        uint32_t length;
+        uint32_t reserved;
+    };
+
+private:
+    template <typename Range>
+    static bool write_range(const std::string& path, const Range& tasks, size_t count,
+                            const TagDictionary& dictionary, uint64_t seq);
+
+    std::string_view str(uint64_t offset, uint32_t length) const;
+
+    MappedFile file;                  ///< Отображённый файл снимка.
+    const Header* header = nullptr;   ///< Заголовок внутри отображения.
+    const Record* records = nullptr;  ///< Таблица задач.
+    const TagRef* names = nullptr;    ///< Таблица имён тегов.
+    const uint32_t* tags = nullptr;   ///< Номера тегов задач в таблице имён.
+    const char* heap = nullptr;       ///< Куча строк.
+};
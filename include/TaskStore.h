@@ -0,0 +1,259 @@
+#pragma once
+#include "Task.h"
+#include "Deadline.h"
+#include "IdIndex.h"
+#include "RoaringBitmap.h"
+#include "TaskRange.h"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+class TaskSnapshot;
+
+/**
+ * @class TaskStore
+ * @brief Хранилище задач с разделением на «горячие» и «холодные» данные.
+ *
+ * Поля, по которым идут сканирования (идентификатор, приоритет, статус и
+ * разобранный дедлайн), лежат в плотных параллельных массивах: фильтр по
+ * статусу читает один байт на задачу вместо целой записи Task. Полные
+ * записи (заголовок, описание, теги) хранятся отдельно — в холодной таблице,
+ * к которой обращаются только при выводе конкретной задачи.
+ *
+ * Для каждого тега, статуса и приоритета хранится сжатое множество позиций
+ * задач (RoaringBitmap); множества обновляются при каждом изменении, так что
+ * выборка по сочетанию тегов, статуса и приоритета — операции над множествами.
+ *
+ * Упорядоченный индекс (дедлайн, идентификатор) позволяет обходить задачи
+ * по возрастанию или убыванию дедлайна без копирования и сортировки. Второй
+ * индекс — очередь «что дальше»: (статус, приоритет, дедлайн), из которой
+ * k первых задач читаются за O(k).
+ *
+ * Сводки (число задач по приоритетам и по дедлайнам) тоже ведутся при
+ * каждом изменении, поэтому их чтение не зависит от числа задач.
+ *
+ * Холодная таблица — PersistentVector ручек задач (TaskHandle): records()
+ * отдаёт её снимок за O(1) (например, для записи на диск в фоновом потоке),
+ * а изменение задачи копирует только путь к её листу, если снимок ещё жив,
+ * — указатели, а не строки и теги. Сами задачи неизменяемы: правка кладёт
+ * в позицию новую задачу, старая живёт, пока на неё ссылаются.
+ *
+ * Позиция задачи (slot) стабильна до уплотнения. Удалённая задача остаётся
+ * надгробием: id == 0 в горячих столбцах и пустая ручка в холодной таблице;
+ * когда надгробий больше половины, хранилище уплотняется.
+ *
+ * После загрузки из двоичного снимка хранилище читает его на месте: горячие
+ * столбцы, множества позиций и индекс идентификаторов строятся прямо из
+ * таблицы записей, а ручки задач — при первом обращении к записи. Упорядоченные
+ * индексы и календарь собираются при первом запросе. Поэтому часть методов
+ * чтения достраивает внутренние структуры, но наблюдаемое состояние не меняют.
+ */
+class TaskStore {
+public:
+    /// Ключ упорядоченного индекса: разобранный дедлайн, затем идентификатор.
+    using DeadlineKey = std::pair<DeadlineTime, TaskId>;
+
+    /**
+     * @brief Ключ очереди «что дальше»: сначала активные, затем более
+     * высокий приоритет, более ранний дедлайн и меньший идентификатор.
+     */
+    using NextKey = std::tuple<Status, uint8_t, DeadlineTime, TaskId>;
+
+    /**
+     * @brief Добавляет задачу с новым идентификатором.
+     * @param task Задача (её поле id игнорируется).
+     * @return Назначенный идентификатор.
+     */
+    TaskId add(Task task);
+
+    /**
+     * @brief Добавляет задачу, сохраняя её идентификатор, если он свободен.
+     * @param task Задача.
+     * @return Идентификатор задачи в хранилище.
+     */
+    TaskId insert(Task task);
+
+    /**
+     * @brief Заменяет задачу в позиции, сохраняя её идентификатор.
+     * @param slot Позиция.
+     * @param task Новое содержимое.
+     */
+    void assign(size_t slot, Task task);
+
+    /**
+     * @brief Заменяет задачу в позиции готовой ручкой без копирования.
+     * @param slot Позиция.
+     * @param task Новое содержимое с идентификатором задачи в этой позиции.
+     */
+    void assign(size_t slot, TaskHandle task);
+
+    /**
+     * @brief Удаляет задачу (оставляет надгробие).
+     * @param slot Позиция.
+     */
+    void erase(size_t slot);
+
+    /**
+     * @brief Возвращает удалённую задачу с её идентификатором.
+     *
+     * Если позиция всё ещё надгробие (хранилище не уплотнялось), задача
+     * встаёт на прежнее место, иначе добавляется в конец.
+     * @param slot Позиция, которую задача занимала до удаления.
+     * @param task Задача с прежним идентификатором.
+     */
+    void revive(size_t slot, TaskHandle task);
+
+    /**
+     * @brief Позиция задачи по идентификатору за O(1).
+     * @return Позиция или IdIndex::npos.
+     */
+    size_t find(TaskId id) const { return index.find(id); }
+
+    /**
+     * @brief Заменяет всё содержимое записями (после загрузки или отката).
+     * @param records Записи, возможно с надгробиями.
+     * @param assign_missing Назначить идентификаторы записям без них и повторам;
+     * иначе записи с id == 0 считаются надгробиями.
+     * @return true, если пришлось назначить новые идентификаторы.
+     */
+    bool restore(std::vector<Task> records, bool assign_missing);
+
+    /**
+     * @brief Заменяет всё содержимое снимком холодной таблицы (см. records()).
+     *
+     * Задачи не копируются: хранилище начинает делить их со снимком.
+     * @param records Снимок, возможно с надгробиями.
+     * @return true, если пришлось назначить новые идентификаторы.
+     */
+    bool restore(const TaskTable& records);
+
+    /**
+     * @brief Заменяет всё содержимое задачами двоичного снимка, не собирая их.
+     *
+     * Снимок живёт, пока не собраны все записи (см. описание класса).
+     * @param snapshot Открытый снимок.
+     * @param tag_ids Результат TaskSnapshot::intern_names().
+     * @return true, если пришлось назначить новые идентификаторы.
+     */
+    bool restore(std::shared_ptr<const TaskSnapshot> snapshot, std::vector<TagId> tag_ids);
+
+    void clear();
+    void reserve(size_t count);
+
+    /// Количество живых задач.
+    size_t size() const { return live; }
+
+    /// Количество позиций вместе с надгробиями.
+    size_t slot_count() const { return ids.size(); }
+
+    TaskId id(size_t slot) const { return ids[slot]; }
+    Priority priority(size_t slot) const { return priorities[slot]; }
+    Status status(size_t slot) const { return statuses[slot]; }
+    DeadlineTime deadline(size_t slot) const { return deadlines[slot]; }
+
+    /**
+     * @brief Позиции живых задач с тегом.
+     * @param tag Идентификатор тега.
+     */
+    const RoaringBitmap& tag_slots(TagId tag) const;
+
+    /// Позиции живых задач со статусом.
+    const RoaringBitmap& status_slots(Status s) const { return by_status[static_cast<size_t>(s)]; }
+
+    /// Позиции живых задач с приоритетом.
+    const RoaringBitmap& priority_slots(Priority p) const { return by_priority[static_cast<size_t>(p)]; }
+
+    /**
+     * @brief Живые задачи по возрастанию дедлайна (равные — по идентификатору).
+     *
+     * Задачи без распознанного дедлайна (kNoDeadline) идут в конце.
+     */
+    const std::set<DeadlineKey>& deadline_order() const {
+        build_orders();
+        return by_deadline;
+    }
+
+    /// Живые задачи в порядке очереди «что дальше» (см. NextKey).
+    const std::set<NextKey>& next_order() const {
+        build_orders();
+        return by_next;
+    }
+
+    /// Число живых задач с приоритетом.
+    int priority_count(Priority p) const { return priority_counts[static_cast<size_t>(p)]; }
+
+    /// Число живых задач по строке дедлайна (без нулевых записей).
+    const std::map<std::string, int>& deadline_counts() const {
+        build_orders();
+        return calendar;
+    }
+
+    /// Позиции всех живых задач.
+    const RoaringBitmap& live_slots() const { return alive; }
+
+    /// Полная запись задачи из холодной таблицы (для надгробия — пустая задача с id == 0).
+    const Task& record(size_t slot) const {
+        const TaskHandle& task = handle(slot);
+        return task ? *task : tombstone();
+    }
+
+    /// Ручка задачи: её копия переживает любые изменения хранилища.
+    const TaskHandle& handle(size_t slot) const {
+        if (unloaded != 0 && ids[slot] != 0 && !cold[slot]) load(slot);
+        return cold[slot];
+    }
+
+    /// Все записи вместе с надгробиями; копия — снимок за O(1).
+    const TaskTable& records() const {
+        load_all();
+        return cold;
+    }
+
+    /// Живые задачи в порядке добавления.
+    TaskRange tasks() const {
+        load_all();
+        return TaskRange(cold, live);
+    }
+
+private:
+    void push(TaskHandle task);
+    void push_tombstone();
+    void fill(size_t slot, TaskHandle task);
+    void replace(size_t slot, TaskHandle task);
+    void compact();
+    void index_slot(size_t slot, const Task& task);
+    void unindex_slot(size_t slot, const Task& task);
+    void clear_sets();
+    void count(const Task& task, int delta);
+    NextKey next_key(size_t slot) const;
+    void load(size_t slot) const;
+    void load_all() const;
+    void build_orders() const;
+    static const Task& tombstone();
+
+    std::vector<TaskId> ids;                            ///< Горячий столбец: идентификатор (0 — надгробие).
+    std::vector<Priority> priorities;                   ///< Горячий столбец: приоритет.
+    std::vector<Status> statuses;                       ///< Горячий столбец: статус.
+    std::vector<DeadlineTime> deadlines;                ///< Горячий столбец: разобранный дедлайн.
+    mutable TaskTable cold;                             ///< Холодная таблица с полными записями.
+    IdIndex index;                                      ///< Идентификатор → позиция.
+    std::vector<RoaringBitmap> by_tag;                  ///< Тег → позиции задач с ним.
+    RoaringBitmap by_status[2];                         ///< Статус → позиции задач.
+    RoaringBitmap by_priority[3];                       ///< Приоритет → позиции задач.
+    RoaringBitmap alive;                                ///< Позиции живых задач.
+    mutable std::set<DeadlineKey> by_deadline;          ///< Упорядоченный индекс по дедлайну.
+    mutable std::set<NextKey> by_next;                  ///< Очередь «что дальше».
+    int priority_counts[3] = {};                        ///< Число задач по приоритетам.
+    mutable std::map<std::string, int> calendar;        ///< Число задач по дедлайну.
+    mutable bool ordered = true;                        ///< Упорядоченные индексы и календарь построены.
+    size_t live = 0;                                    ///< Количество живых задач.
+    TaskId next_id = 1;                                 ///< Следующий свободный идентификатор.
+    mutable std::shared_ptr<const TaskSnapshot> source; ///< Снимок с ещё не собранными записями.
+    mutable std::vector<TagId> source_tags;             ///< Имена тегов снимка → теги словаря.
+    mutable size_t unloaded = 0;                        ///< Живые записи снимка без ручки в cold.
+};
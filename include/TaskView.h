@@ -0,0 +1,105 @@
+#pragma once
+#include "TaskStore.h"
+#include "RoaringBitmap.h"
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+/**
+ * @class TaskView
+ * @brief Выборка задач: множество позиций поверх TaskStore без копирования задач.
+ *
+ * Выборка либо владеет вычисленным множеством (результат запроса), либо
+ * ссылается на множество, которое поддерживает само хранилище (например,
+ * все задачи со статусом Active), — тогда создание выборки O(1).
+ * Задачи перечисляются в порядке добавления. Выборка действительна до
+ * следующего изменения списка задач.
+ */
+class TaskView {
+public:
+    /// Итератор по задачам выборки.
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Task;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Task*;
+        using reference = const Task&;
+
+        iterator(const TaskStore* store, RoaringBitmap::const_iterator pos) : store(store), pos(pos) {}
+
+        reference operator*() const { return store->record(*pos); }
+        pointer operator->() const { return &store->record(*pos); }
+
+        iterator& operator++() {
+            ++pos;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator copy = *this;
+            ++pos;
+            return copy;
+        }
+
+        bool operator==(const iterator& other) const { return pos == other.pos; }
+        bool operator!=(const iterator& other) const { return pos != other.pos; }
+
+    private:
+        const TaskStore* store;           ///< Хранилище задач.
+        RoaringBitmap::const_iterator pos; ///< Текущая позиция.
+    };
+
+    /**
+     * @brief Создаёт выборку, владеющую множеством позиций.
+     * @param store Хранилище задач.
+     * @param slots Позиции задач в хранилище.
+     */
+    TaskView(const TaskStore& store, RoaringBitmap slots)
+        : store(&store), owned(std::move(slots)), slots(&owned) {}
+
+    /**
+     * @brief Создаёт выборку, ссылающуюся на множество позиций хранилища.
+     * @param store Хранилище задач.
+     * @param slots Множество, которое живёт не меньше выборки.
+     */
+    TaskView(const TaskStore& store, const RoaringBitmap* slots) : store(&store), slots(slots) {}
+
+    TaskView(const TaskView& other) : store(other.store), owned(other.owned), slots(other.target(&owned)) {}
+    TaskView(TaskView&& other) noexcept
+        : store(other.store), owned(std::move(other.owned)), slots(other.target(&owned)) {}
+    TaskView& operator=(TaskView other) noexcept {
+        store = other.store;
+        owned = std::move(other.owned);
+        slots = other.target(&owned);
+        return *this;
+    }
+
+    iterator begin() const { return iterator(store, slots->begin()); }
+    iterator end() const { return iterator(store, slots->end()); }
+
+    size_t size() const { return static_cast<size_t>(slots->cardinality()); }
+    bool empty() const { return slots->empty(); }
+
+    /// Позиции задач выборки.
+    const RoaringBitmap& positions() const { return *slots; }
+
+    /// Копия задач выборки.
+    std::vector<Task> to_vector() const { return std::vector<Task>(begin(), end()); }
+
+    /// Ручки задач выборки: копируются указатели, а не задачи.
+    std::vector<TaskHandle> handles() const {
+        std::vector<TaskHandle> out;
+        out.reserve(size());
+        for (uint32_t slot : *slots) out.push_back(store->handle(slot));
+        return out;
+    }
+
+private:
+    /// Куда указывать копии: на своё множество, если выборка им владеет.
+    const RoaringBitmap* target(const RoaringBitmap* own) const { return slots == &owned ? own : slots; }
+
+    const TaskStore* store;      ///< Хранилище задач.
+    RoaringBitmap owned;         ///< Собственное множество позиций.
+    const RoaringBitmap* slots;  ///< Позиции задач: owned или множество хранилища.
+};
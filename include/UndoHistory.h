@@ -0,0 +1,120 @@
+#pragma once
+#include "TaskChange.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+
+/**
+ * @class UndoHistory
+ * @brief Стек операций отмены с ограничением по памяти.
+ *
+ * Для каждой записи считается, сколько байт она держит в памяти: сама
+ * структура, задачи (со строками вне встроенного буфера и тегами) и, для
+ * снимка всего списка, узлы PersistentVector. Общие с хранилищем задачи и
+ * узлы тоже считаются: хранилище может отпустить их в любой момент, и
+ * тогда память останется только за историей, а пересчитывать записи
+ * задним числом некому.
+ *
+ * Две истории (отмены и повтора) могут делить один бюджет (share_budget):
+ * тогда ограничена их общая память, и длинная серия откатов не выносит
+ * записи за бюджет. Когда сумма превышает
+ * бюджет, самые старые записи сериализуются, сжимаются (lz_compress) и
+ * дописываются во временный файл пользователя, а в памяти остаётся только
+ * их положение в файле. Откат до такой записи читает и распаковывает её.
+ *
+ * Выгруженные записи всегда образуют начало стека и лежат в файле по
+ * порядку, поэтому файл работает как стек: снятая запись освобождает
+ * свой хвост файла для следующих выгрузок.
+ */
+class UndoHistory {
+public:
+    /// Бюджет по умолчанию.
+    static constexpr size_t kDefaultBudget = 64u << 20;
+
+    /**
+     * @brief Создаёт пустую историю.
+     * @param spill_path Файл для выгруженных записей (создаётся при первой выгрузке).
+     * @param budget Сколько байт записи могут занимать в памяти.
+     */
+    explicit UndoHistory(std::string spill_path, size_t budget = kDefaultBudget);
+
+    /**
+     * @brief Удаляет файл выгрузки.
+     */
+    ~UndoHistory();
+
+    UndoHistory(const UndoHistory&) = delete;
+    UndoHistory& operator=(const UndoHistory&) = delete;
+
+    /**
+     * @brief Кладёт запись на вершину; при превышении бюджета выгружает старые.
+     * @param change Операция отмены.
+     */
+    void push(TaskChange change);
+
+    /**
+     * @brief Снимает запись с вершины, при необходимости читая её с диска.
+     * @param out Снятая запись.
+     * @return false, если история пуста или запись не прочиталась.
+     */
+    bool pop(TaskChange& out);
+
+    void clear();
+
+    /**
+     * @brief Меняет бюджет; лишние записи выгружаются сразу.
+     * @param bytes Бюджет в байтах.
+     */
+    void set_budget(size_t bytes);
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    /**
+     * @brief Делит бюджет с другой историей: ограничивается их общая память.
+     *
+     * Бюджет другой истории становится равным бюджету этой; set_budget
+     * любой из них меняет его у обеих. Истории должны жить одинаково долго.
+     * @param other Парная история (например, стек повтора).
+     */
+    void share_budget(UndoHistory& other);
+
+    /// Байт, которые записи держат в памяти.
+    size_t memory_bytes() const { return resident; }
+
+    /// Количество записей, выгруженных на диск.
+    size_t spilled() const { return spilled_count; }
+
+    /**
+     * @brief Сколько байт держит запись в памяти.
+     * @param change Операция отмены.
+     */
+    static size_t bytes_of(const TaskChange& change);
+
+private:
+    /// Запись в памяти или ссылка на её сжатую копию в файле.
+    struct Entry {
+        TaskChange change;        ///< Запись (пусто, если выгружена).
+        size_t bytes = 0;         ///< Учтённый размер в памяти.
+        bool on_disk = false;     ///< Запись выгружена.
+        uint64_t offset = 0;      ///< Смещение сжатой записи в файле.
+        uint64_t stored = 0;      ///< Размер сжатой записи.
+        uint64_t raw = 0;         ///< Размер до сжатия.
+    };
+
+    void enforce();
+    bool spill_oldest();
+    bool spill(Entry& entry);
+    bool load(Entry& entry);
+
+    std::string path;           ///< Файл выгрузки.
+    std::fstream file;          ///< Открытый файл выгрузки.
+    size_t budget;              ///< Бюджет памяти.
+    std::deque<Entry> entries;  ///< Записи, самая новая — в конце.
+    size_t resident = 0;        ///< Сумма bytes записей в памяти.
+    size_t spilled_count = 0;   ///< Сколько записей в начале выгружено.
+    uint64_t file_end = 0;      ///< Конец занятой части файла.
+    UndoHistory* peer = nullptr; ///< История с общим бюджетом.
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include "Deadline.h"
+#include "Task.h"
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @enum Urgency
+ * @brief Срочность задачи относительно текущего момента.
+ */
+enum class Urgency : uint8_t {
+    Normal,  ///< До дедлайна больше суток (или дедлайна нет).
+    Urgent,  ///< Дедлайн наступит в течение 24 часов.
+    Overdue  ///< Дедлайн прошёл.
+};
+
+/**
+ * @class UrgencyCache
+ * @brief Кэш срочности задач, пересчитываемый только на границах.
+ *
+ * Срочность задачи меняется лишь в два момента: за сутки до дедлайна и в
+ * сам дедлайн. Для каждой задачи в кэше хранится текущая срочность, а
+ * ближайшие моменты смены лежат в min-куче. advance() сдвигает «сейчас» и
+ * пересчитывает только задачи, чья граница уже пройдена, — если ни одна
+ * граница не пройдена, это одно сравнение с вершиной кучи.
+ *
+ * Изменённый дедлайн замечается в classify(): запись пересчитывается, а
+ * устаревшие элементы кучи отбрасываются при извлечении. Если устаревших
+ * элементов становится больше, чем живых, куча пересобирается из записей.
+ */
+class UrgencyCache {
+public:
+    /**
+     * @brief Срочность дедлайна в момент now (как прежние isOverdue/isUrgent).
+     * @param due Разобранный дедлайн.
+     * @param now Текущий момент.
+     */
+    static Urgency classify_at(DeadlineTime due, DeadlineTime now);
+
+    /**
+     * @brief Сдвигает текущий момент и пересчитывает задачи с пройденной границей.
+     * @param now Текущий момент (не меньше предыдущего).
+     * @return Число пересчитанных задач.
+     */
+    size_t advance(DeadlineTime now);
+
+    /**
+     * @brief Срочность задачи на момент последнего advance().
+     * @param id Идентификатор задачи.
+     * @param due Её текущий разобранный дедлайн.
+     */
+    Urgency classify(TaskId id, DeadlineTime due);
+
+    /// Убирает удалённую или изменённую задачу из кэша.
+    void forget(TaskId id);
+
+    void clear();
+
+    /// Количество задач в кэше.
+    size_t size() const { return entries.size(); }
+
+    /// Количество элементов кучи, включая устаревшие.
+    size_t pending() const { return transitions.size(); }
+
+private:
+    /// Срочность задачи и дедлайн, по которому она посчитана.
+    struct Entry {
+        DeadlineTime due;
+        Urgency urgency;
+        DeadlineTime at; ///< Момент её живого элемента в куче, kNoDeadline — элемента нет.
+    };
+
+    /// Момент смены срочности задачи.
+    struct Transition {
+        DeadlineTime at; ///< Когда срочность сменится.
+        TaskId id;       ///< Задача.
+        DeadlineTime due; ///< Дедлайн, для которого посчитан момент.
+
+        bool operator>(const Transition& other) const { return at > other.at; }
+    };
+
+    /// Запоминает срочность и планирует её следующую смену.
+    Urgency schedule(TaskId id, DeadlineTime due);
+
+    /// Отмечает, что живой элемент записи в куче устарел.
+    void retire(Entry& entry);
+
+    /// Пересобирает кучу из живых элементов, если устаревших стало слишком много.
+    void prune();
+
+    std::unordered_map<TaskId, Entry> entries; ///< Задача → текущая срочность.
+    std::priority_queue<Transition, std::vector<Transition>, std::greater<Transition>> transitions; ///< Ближайшие смены.
+    size_t stale = 0; ///< Устаревших элементов в куче.
+    DeadlineTime now = 0; ///< Момент последнего advance().
+};
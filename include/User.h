@@ -1,17 +1,370 @@
 #pragma once
 #include "Task.h"
+#include "TaskSnapshot.h"
+#include "PersistBatch.h"
+#include "TaskStore.h"
+#include "TaskView.h"
+#include "DeadlineView.h"
+#include "TagQuery.h"
+#include "UndoHistory.h"
+#include "TaskOp.h"
 #include <vector>
 #include <string>
+#include <map>
+#include <cstdint>
 
+/**
+ * @class User
+ * @brief Класс, представляющий пользователя и его задачи.
+ *
+ * Задачи хранятся в двоичном снимке `<имя>_tasks.bin` (см. TaskSnapshot)
+ * и журнале изменений `<имя>_tasks.log`. Если двоичного снимка ещё нет,
+ * задачи импортируются из `<имя>_tasks.json`, `.cbor` или `.msgpack`
+ * (формат выбирается по расширению, см. TaskCodec).
+ *
+ * Каждая мутация добавляет запись в буфер журнала; take_changes() забирает
+ * буфер в виде PersistBatch (при разрастании журнала — вместе с полным
+ * снимком), которую можно записать синхронно через save_to_file() или
+ * в фоне через PersistenceWorker.
+ *
+ * Сами задачи лежат в TaskStore: статистика и фильтр по статусу сканируют
+ * его плотные столбцы, не затрагивая полные записи. Теги задач — номера
+ * в словаре пользователя (см. TagDictionary).
+ */
 class User {
 public:
+    /**
+     * @brief Конструктор по имени пользователя.
+     * @param name Имя пользователя.
+     */
     User(const std::string& name);
-    void add_task(const Task& task);
-    void delete_task(size_t index);
-    std::vector<Task> search_tasks(const std::string& keyword) const;
-    const std::vector<Task>& get_tasks() const;
+
+    /**
+     * @brief Добавляет новую задачу и назначает ей идентификатор.
+     * @param task Задача для добавления (её поле id игнорируется).
+     * @return Идентификатор добавленной задачи.
+     */
+    TaskId add_task(const Task& task);
+
+    /**
+     * @brief Удаляет задачу по идентификатору.
+     * @param id Идентификатор задачи.
+     */
+    void delete_task(TaskId id);
+
+    /**
+     * @brief Редактирует задачу по идентификатору; идентификатор сохраняется.
+     * @param id Идентификатор задачи.
+     * @param updated_task Обновленная задача.
+     */
+    void edit_task(TaskId id, const Task& updated_task);
+
+    /**
+     * @brief Применяет пачку добавлений, правок и удалений за один проход.
+     *
+     * Вся пачка — одна запись истории: undo() откатывает её целиком.
+     * Столбцы и индекс хранилища резервируются один раз. Пачку, в которой
+     * операций больше, чем журнал держит до сворачивания, выгоднее записать
+     * снимком: тогда записи журнала не формируются, а следующее сохранение
+     * пишет снимок. На диск пачка попадает одним save_to_file().
+     * @param ops Операции в порядке выполнения.
+     * @return Для каждой операции идентификатор задачи (новый для Add) или 0,
+     * если задачи для правки или удаления нет.
+     */
+    std::vector<TaskId> apply_batch(std::vector<TaskOp> ops);
+
+    /**
+     * @brief Ищет задачу по идентификатору за O(1).
+     * @param id Идентификатор задачи.
+     * @return Указатель на задачу или nullptr.
+     */
+    const Task* find_task(TaskId id) const;
+
+    /**
+     * @brief Сохраняет накопленные изменения: дописывает их в журнал
+     * или, если журнал разросся, записывает новый снимок.
+     */
+    void save_to_file();
+
+    /**
+     * @brief Загружает задачи пользователя: читает снимок и проигрывает журнал.
+     *
+     * Файл импорта (JSON, CBOR, MessagePack) читается, только если снимка нет.
+     * Повреждённый снимок, испорченная запись журнала или нечитаемый файл
+     * импорта — std::runtime_error.
+     */
+    void load_from_file();
+
+    /**
+     * @brief Выгружает все задачи в файл; формат выбирается по расширению.
+     * @param path Путь к файлу (.json, .cbor или .msgpack).
+     * @return true при успешной записи.
+     */
+    bool export_tasks(const std::string& path) const;
+
+    /**
+     * @brief Заменяет задачи содержимым файла; формат выбирается по расширению.
+     * @param path Путь к файлу (.json, .cbor или .msgpack).
+     * @return true, если файл прочитан без ошибок.
+     */
+    bool import_tasks(const std::string& path);
+
+    /**
+     * @brief Записывает полный снимок задач и очищает журнал.
+     */
+    void compact();
+
+    /**
+     * @brief Забирает накопленные изменения для записи на диск.
+     *
+     * Если журнал разросся или изменения нельзя выразить записями,
+     * пачка содержит полный снимок задач.
+     * @return Пачка изменений, не зависящая от объекта User.
+     */
+    PersistBatch take_changes();
+
+    /**
+     * @brief Требует записать полный снимок при следующем сохранении
+     * (например, после неудачной записи журнала).
+     */
+    void request_snapshot() { needs_snapshot = true; }
+
+    /**
+     * @brief Откатывает последнее изменение задач.
+     *
+     * История хранит обратные операции (какую задачу удалить, какое
+     * прежнее значение вернуть, какую удалённую задачу и куда поставить),
+     * поэтому откат стоит O(1) и пишет в журнал обычную запись. Удалённая
+     * задача возвращается на прежнее место в списке; после перезагрузки до
+     * следующего снимка она окажется в конце.
+     */
+    void undo();
+
+    /**
+     * @brief Повторяет последнее откатанное изменение.
+     *
+     * Стек повтора очищается любым новым изменением задач.
+     */
+    void redo();
+
+    /**
+     * @brief Ограничивает общую память историй отмены и повтора.
+     *
+     * Старые записи сверх бюджета сжимаются и выгружаются во временный
+     * файл пользователя; undo() и redo() читают их обратно по мере надобности.
+     * @param bytes Бюджет в байтах (по умолчанию UndoHistory::kDefaultBudget).
+     */
+    void set_undo_budget(size_t bytes) { history.set_budget(bytes); }
+
+    /**
+     * @brief История отмены (размер, занятая память, число выгруженных записей).
+     */
+    const UndoHistory& undo_history() const { return history; }
+
+    /**
+     * @brief Возвращает идентификатор тега, при необходимости добавляя его в словарь.
+     * @param name Имя тега.
+     */
+    TagId intern_tag(const std::string& name) { return dictionary.intern(name); }
+
+    /**
+     * @brief Переименовывает тег во всех задачах сразу.
+     *
+     * Меняется только запись словаря; в журнал пишется одна запись.
+     * Переименование не попадает в историю отката.
+     * @param from Текущее имя тега.
+     * @param to Новое имя тега.
+     * @return false, если тега from нет или имя to уже занято.
+     */
+    bool rename_tag(const std::string& from, const std::string& to);
+
+    /**
+     * @brief Словарь тегов пользователя.
+     */
+    const TagDictionary& tags() const { return dictionary; }
+
+    /**
+     * @brief Ищет задачи по ключевому слову в заголовке или описании.
+     * @param keyword Ключевое слово.
+     * @return Ручки найденных задач; остаются действительными после изменений.
+     */
+    std::vector<TaskHandle> search_tasks(const std::string& keyword) const;
+
+    /**
+     * @brief Фильтрует задачи по тегу.
+     * @param tag Название тега.
+     * @return Ручки задач с указанным тегом; остаются действительными после изменений.
+     */
+    std::vector<TaskHandle> filter_by_tag(const std::string& tag) const;
+
+    /**
+     * @brief Выбирает задачи по логическому выражению над тегами.
+     *
+     * Вычисляется пересечениями и объединениями множеств позиций, которые
+     * поддерживаются при каждом изменении задач; сами задачи не копируются.
+     * @param query Выражение, например `work AND urgent AND NOT blocked`.
+     * @return Выборка, действительная до следующего изменения задач.
+     */
+    TaskView filter_by_tags(const TagQuery& query) const;
+
+    /**
+     * @brief Все задачи в порядке дедлайна без копирования и сортировки.
+     *
+     * Порядок поддерживается индексом при каждом изменении; задачи с равным
+     * дедлайном идут по идентификатору, без распознанного дедлайна — в конце
+     * (при обходе по убыванию — в начале).
+     * @param descending Обходить по убыванию дедлайна.
+     * @return Выборка, действительная до следующего изменения задач.
+     */
+    DeadlineView tasks_by_deadline(bool descending = false) const;
+
+    /**
+     * @brief Задачи с дедлайном в полуинтервале [from, to) за O(log n + k).
+     *
+     * Границы ищутся в упорядоченном индексе дедлайнов, затем выборка идёт
+     * курсором по найденному отрезку.
+     * @param from Начало интервала (включительно).
+     * @param to Конец интервала (не включительно).
+     * @param descending Обходить по убыванию дедлайна.
+     * @return Выборка, действительная до следующего изменения задач.
+     */
+    DeadlineView tasks_due_between(DeadlineTime from, DeadlineTime to, bool descending = false) const;
+
+    /**
+     * @brief k первых задач очереди «что дальше» за O(k).
+     *
+     * Порядок: активные раньше выполненных, затем по убыванию приоритета,
+     * по возрастанию дедлайна (без дедлайна — в конце) и идентификатора.
+     * Очередь — упорядоченный индекс, который обновляется за O(log n) при
+     * каждом изменении задачи, поэтому чтение не обходит весь список.
+     * @param k Сколько задач вернуть.
+     * @return Указатели на задачи, действительные до следующего изменения.
+     */
+    std::vector<const Task*> next_up(size_t k) const;
+
+    /**
+     * @brief Получает статистику задач по приоритетам.
+     *
+     * Счётчики ведутся при каждом изменении (и при откате), чтение — O(1).
+     * @return Отображение количества задач для каждого приоритета.
+     */
+    std::map<Priority, int> get_priority_stats() const;
+
+    /**
+     * @brief Календарь дедлайнов с подсчетом задач на каждый день.
+     *
+     * Сводка ведётся при каждом изменении (и при откате), а не строится заново.
+     * @return Отображение количества задач по дате дедлайна; действительно до
+     * следующего изменения задач.
+     */
+    const std::map<std::string, int>& get_deadline_calendar() const;
+
+    /**
+     * @brief Фильтрует задачи по статусу за O(1): множество задач каждого
+     * статуса поддерживается при изменениях.
+     * @param status Статус задачи (Active или Done).
+     * @return Выборка, действительная до следующего изменения задач.
+     */
+    TaskView filter_by_status(Status status) const;
+
+    /**
+     * @brief Фильтрует задачи по приоритету за O(1).
+     * @param priority Приоритет задачи.
+     * @return Выборка, действительная до следующего изменения задач.
+     */
+    TaskView filter_by_priority(Priority priority) const;
+
+    /**
+     * @brief Задачи с заданными статусом и приоритетом (пересечение двух множеств).
+     * @param status Статус задачи.
+     * @param priority Приоритет задачи.
+     * @return Выборка, действительная до следующего изменения задач.
+     */
+    TaskView filter_by_status_and_priority(Status status, Priority priority) const;
+
+    /**
+     * @brief Возвращает все задачи пользователя (без удалённых).
+     * @return Диапазон, действительный до следующего изменения задач.
+     */
+    TaskRange get_tasks() const;
+
+    /**
+     * @brief Возвращает имя пользователя.
+     */
+    const std::string& get_name() const { return username; }
 
 private:
-    std::string username;
-    std::vector<Task> tasks;
+    /**
+     * @brief Записывает операцию отмены нового изменения и очищает стек повтора.
+     * @param change Операция отмены.
+     */
+    void remember(TaskChange change);
+
+    /**
+     * @brief Выполняет операцию и превращает её в обратную.
+     * @param change Операция отката или повтора.
+     */
+    void revert(TaskChange& change);
+
+    /**
+     * @brief Добавляет задачу и заполняет операцию её отмены.
+     * @return Назначенный идентификатор.
+     */
+    TaskId add_one(Task task, TaskChange& undo);
+
+    /**
+     * @brief Заменяет задачу и заполняет операцию отмены.
+     * @return false, если задачи нет.
+     */
+    bool edit_one(TaskId id, Task task, TaskChange& undo);
+
+    /**
+     * @brief Удаляет задачу и заполняет операцию отмены.
+     * @return false, если задачи нет.
+     */
+    bool delete_one(TaskId id, TaskChange& undo);
+
+    /**
+     * @brief Сколько записей журнал копит до сворачивания в снимок.
+     */
+    size_t log_limit() const;
+
+    /**
+     * @brief Добавляет запись о мутации в буфер журнала.
+     * @param record Запись без порядкового номера.
+     */
+    void record(json record);
+
+    /**
+     * @brief Применяет запись журнала к задачам (при загрузке).
+     * @param record Запись журнала.
+     */
+    void apply_record(const json& record);
+
+    /**
+     * @brief Читает задачи из файла в формате, определяемом расширением.
+     * @param path Путь к файлу.
+     * @param out Куда сложить задачи.
+     * @param dictionary Словарь, в который добавляются имена тегов.
+     * @param file_seq Номер записи журнала из файла, если он там есть.
+     * @param error Описание ошибки.
+     * @return false, если файл не открылся или повреждён.
+     */
+    static bool read_tasks(const std::string& path, std::vector<Task>& out, TagDictionary& dictionary,
+                           uint64_t& file_seq, std::string& error);
+
+    std::string snapshot_path() const { return username + "_tasks.bin"; }
+    std::string log_path() const { return username + "_tasks.log"; }
+
+    std::string username;                   ///< Имя пользователя.
+    TaskStore tasks;                        ///< Задачи пользователя.
+    TagDictionary dictionary;               ///< Имена тегов задач.
+    UndoHistory history;                    ///< Операции отмены, последняя — на вершине.
+    UndoHistory redo_stack;                 ///< Откатанные изменения для повтора (бюджет общий с history).
+    std::string pending;                    ///< Записи, ещё не дописанные в журнал.
+    size_t pending_count = 0;               ///< Количество записей в pending.
+    size_t logged_records = 0;              ///< Записей в журнале на диске.
+    uint64_t seq = 0;                       ///< Номер последней записи журнала.
+    bool needs_snapshot = false;            ///< Изменения нельзя выразить записями журнала.
+    bool logging = true;                    ///< Писать записи журнала (выключается на время крупной пачки).
 };
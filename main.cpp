@@ -21,66 +21,15 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
-
-using json = nlohmann::json;
-
-/**
- * @enum Priority
- * @brief Перечисление уровней приоритета задачи.
- */
-enum class Priority { Low, Medium, High };
-
-/**
- * @enum Status
- * @brief Перечисление состояний выполнения задачи.
- */
-enum class Status { Active, Done };
-
-/**
- * @brief Преобразует перечисление Priority в строку.
- * @param p Приоритет.
- * @return Строка, соответствующая приоритету.
- */
-std::string priorityToString(Priority p) {
-    switch (p) {
-        case Priority::Low: return "Low";
-        case Priority::Medium: return "Medium";
-        case Priority::High: return "High";
-    }
-    return "Unknown";
-}
-
-/**
- * @brief Преобразует перечисление Status в строку.
- * @param s Статус.
- * @return Строка, соответствующая статусу.
- */
-std::string statusToString(Status s) {
-    return s == Status::Active ? "Active" : "Done";
-}
-
-
-/**
- * @brief Преобразует строку в соответствующее значение перечисления Priority.
- * @param str Строка "Low", "Medium", или "High".
- * @return Значение Priority.
- */
-Priority stringToPriority(const std::string& str) {
-    if (str == "Low") return Priority::Low;
-    if (str == "Medium") return Priority::Medium;
-    return Priority::High;
-}
-
-
-/**
- * @brief Преобразует строку в соответствующее значение перечисления Status.
- * @param str Строка "Active" или "Done".
- * @return Значение Status.
- */
-Status stringToStatus(const std::string& str) {
-    return str == "Active" ? Status::Active : Status::Done;
-}
-
+#include <chrono>
+#include <deque>
+#include <limits>
+#include "Task.h"
+#include "User.h"
+#include "PersistenceWorker.h"
+#include "UrgencyCache.h"
+#include "ReminderWheel.h"
+#include "ReminderTimer.h"
 
 /**
  * @brief Возвращает цвет, связанный с приоритетом задачи.
@@ -97,255 +46,6 @@ sf::Color priorityColor(Priority p) {
 }
 
 
-/**
- * @struct Task
- * @brief Структура, описывающая одну задачу.
- */
-struct Task {
-    std::string title;
-    std::string description;
-    Priority priority;
-    Status status;
-    std::string deadline;
-    std::vector<std::string> tags;
-    
-
-    /**
-     * @brief Преобразует задачу в JSON-объект.
-     * @return json, описывающий текущую задачу.
-     */
-    json to_json() const {
-        return json{{"title", title},
-                    {"description", description},
-                    {"priority", priorityToString(priority)},
-                    {"status", statusToString(status)},
-                    {"deadline", deadline},
-                    {"tags", tags}};
-    }
-
-
-    /**
-     * @brief Загружает задачу из JSON-объекта.
-     * @param j json-объект.
-     * @return Task, инициализированный данными из JSON.
-     */
-    static Task from_json(const json& j) {
-        Task t;
-        t.title = j.at("title").get<std::string>();
-        t.description = j.at("description").get<std::string>();
-        t.priority = stringToPriority(j.at("priority"));
-        t.status = stringToStatus(j.at("status"));
-        t.deadline = j.at("deadline").get<std::string>();
-        t.tags = j.at("tags").get<std::vector<std::string>>();
-        return t;
-    }
-};
-
-
-/**
- * @class User
- * @brief Класс, представляющий пользователя и его задачи.
- */
-class User {
-public:
-    std::string name;                   ///< Имя пользователя.
-    std::vector<Task> tasks;           ///< Список задач пользователя.
-    std::stack<std::vector<Task>> history; ///< Стек истории изменений задач для отката.
-
-
-     /**
-     * @brief Конструктор по имени пользователя.
-     * @param username Имя пользователя.
-     */
-    User(const std::string& username) : name(username) {}
-
-
-     /**
-     * @brief Добавляет новую задачу.
-     * @param task Задача для добавления.
-     */
-    void add_task(const Task& task) {
-        save_state();
-        tasks.push_back(task);
-    }
-
-
-    /**
-     * @brief Удаляет задачу по индексу.
-     * @param index Индекс задачи.
-     */
-    void delete_task(size_t index) {
-        if (index < tasks.size()) {
-            save_state();
-            tasks.erase(tasks.begin() + index);
-        }
-    }
-
-
-    /**
-     * @brief Редактирует задачу по индексу.
-     * @param index Индекс задачи.
-     * @param updated_task Обновленная задача.
-     */
-    void edit_task(size_t index, const Task& updated_task) {
-        if (index < tasks.size()) {
-            save_state();
-            tasks[index] = updated_task;
-        }
-    }
-
-
-     /**
-     * @brief Сохраняет задачи пользователя в JSON-файл.
-     */
-    void save_to_file() const {
-        json j;
-        for (const auto& t : tasks) j.push_back(t.to_json());
-        std::ofstream file(name + "_tasks.json");
-        file << j.dump(4);
-    }
-
-    /**
-     * @brief Загружает задачи пользователя из JSON-файла.
-     */
-    void load_from_file() {
-        std::ifstream file(name + "_tasks.json");
-        if (!file.is_open()) return;
-        json j;
-        file >> j;
-        tasks.clear();
-        for (const auto& item : j) tasks.push_back(Task::from_json(item));
-    }
-
-     /**
-     * @brief Откатывает изменения задач до предыдущего состояния.
-     */
-    void undo() {
-        if (!history.empty()) {
-            tasks = history.top();
-            history.pop();
-        }
-    }
-
-    /**
-     * @brief Ищет задачи по ключевому слову в заголовке или описании.
-     * @param keyword Ключевое слово.
-     * @return Вектор найденных задач.
-     */
-    std::vector<Task> search(const std::string& keyword) const {
-        std::vector<Task> result;
-        for (const auto& t : tasks) {
-            if (t.title.find(keyword) != std::string::npos ||
-                t.description.find(keyword) != std::string::npos) {
-                result.push_back(t);
-            }
-        }
-        return result;
-    }
-
-     /**
-     * @brief Фильтрует задачи по тегу.
-     * @param tag Название тега.
-     * @return Вектор задач с указанным тегом.
-     */
-    std::vector<Task> filter_by_tag(const std::string& tag) const {
-        std::vector<Task> result;
-        for (const auto& t : tasks) {
-            if (std::find(t.tags.begin(), t.tags.end(), tag) != t.tags.end()) {
-                result.push_back(t);
-            }
-        }
-        return result;
-    }
-
-    /**
-     * @brief Получает статистику задач по приоритетам.
-     * @return Отображение количества задач для каждого приоритета.
-     */
-    std::map<Priority, int> get_priority_stats() const {
-        std::map<Priority, int> stats;
-        for (const auto& task : tasks) {
-            stats[task.priority]++;
-        }
-        return stats;
-    }
-
-    /**
-     * @brief Создает календарь дедлайнов с подсчетом задач на каждый день.
-     * @return Отображение количества задач по дате дедлайна.
-     */
-    std::map<std::string, int> get_deadline_calendar() const {
-        std::map<std::string, int> calendar;
-        for (const auto& task : tasks) {
-            calendar[task.deadline]++;
-        }
-        return calendar;
-    }
-
-     /**
-     * @brief Фильтрует задачи по статусу.
-     * @param status Статус задачи (Active или Done).
-     * @return Вектор задач с заданным статусом.
-     */
-    std::vector<Task> filter_by_status(Status status) const {
-        std::vector<Task> result;
-        for (const auto& task : tasks) {
-            if (task.status == status) result.push_back(task);
-        }
-        return result;
-    }
-
-    /**
-     * @brief Возвращает ссылку на вектор всех задач пользователя.
-     * @return Ссылка на вектор задач.
-     */
-    std::vector<Task>& get_tasks() {
-        return tasks;
-    }
-
-private: 
-    /**
-     * @brief Сохраняет текущее состояние задач в стек истории.
-     */
-    void save_state() {
-        history.push(tasks);
-    }
-};
-
-/**
- * @brief Проверяет, просрочен ли дедлайн.
- * 
- * @param deadline Строка с дедлайном в формате "YYYY-MM-DD HH:MM".
- * @return true если дедлайн в прошлом, иначе false.
- */
-bool isOverdue(const std::string& deadline) {
-    std::tm tm = {};
-    std::istringstream ss(deadline);
-    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
-    if (ss.fail()) return false;
-
-    std::time_t deadline_time = std::mktime(&tm);
-    return std::difftime(deadline_time, std::time(nullptr)) < 0;
-}
-
-/**
- * @brief Проверяет, истекает ли дедлайн в течение 24 часов.
- * 
- * @param deadline Строка с дедлайном в формате "YYYY-MM-DD HH:MM".
- * @return true если дедлайн наступит в течение 24 часов, иначе false.
- */
-bool isUrgent(const std::string& deadline) {
-    std::tm tm = {};
-    std::istringstream ss(deadline);
-    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
-    if (ss.fail()) return false;
-
-    std::time_t deadline_time = std::mktime(&tm);
-    std::time_t now = std::time(nullptr);
-    double diff = std::difftime(deadline_time, now);
-    return diff > 0 && diff <= 86400;
-}
-
 /**
  * @class InputField
  * @brief Класс для создания текстового поля ввода в интерфейсе SFML.
@@ -439,15 +139,27 @@ private:
     sf::Font font; ///< Шрифт для всех текстовых элементов.
     sf::RenderWindow window; ///< Главное окно приложения.
     std::vector<InputField> fields; ///< Поля ввода задачи.
-    InputField tagFilterField; ///< Поле для фильтрации по тегу.
+    InputField tagFilterField; ///< Поле для фильтрации по тегам (выражение TagQuery).
+    TagQuery tagFilter; ///< Последнее корректное выражение из tagFilterField.
     InputField dateSortField; ///< Поле для сортировки по дате.
     sf::RectangleShape saveButton; ///< Кнопка сохранения задачи.
     sf::Text saveText; ///< Текст на кнопке сохранения.
     sf::RectangleShape calendarButton; ///< Кнопка переключения на календарь.
     sf::Text calendarText; ///< Текст на кнопке календаря.
+    sf::Text saveStatusText; ///< Результат последнего сохранения.
+    PersistenceWorker persistence; ///< Фоновое сохранение задач на диск.
+    std::chrono::seconds saveRetryDelay{0}; ///< Пауза перед повтором сохранения, 0 — повтор не нужен.
+    std::chrono::steady_clock::time_point saveRetryAt; ///< Когда повторить неудавшееся сохранение.
     std::vector<sf::FloatRect> taskRects; ///< Прямоугольники задач для кликов.
     std::vector<sf::FloatRect> deleteRects; ///< Прямоугольники кнопок удаления задач.
-    int editingIndex = -1; ///< Индекс редактируемой задачи, -1 если создаётся новая.
+    std::vector<TaskId> rowIds; ///< Идентификаторы задач в строках списка (параллельно taskRects).
+    TaskId editingId = 0; ///< Идентификатор редактируемой задачи, 0 если создаётся новая.
+    UrgencyCache urgency; ///< Срочность задач; пересчитывается только на границах.
+    ReminderWheel reminders; ///< Напоминания «остались сутки» и «дедлайн наступил».
+    ReminderTimer reminderTimer; ///< Будильник следующего тика колеса напоминаний.
+    std::deque<std::string> reminderLog; ///< Последние напоминания, новые сверху.
+    sf::Text reminderText; ///< Вывод последних напоминаний.
+    sf::Text nextUpText; ///< Панель «Next up»: самые срочные задачи.
     float scrollOffset = 0; ///< Отступ прокрутки по вертикали.
     bool calendarView = false; ///< Флаг режима отображения календаря.
 
@@ -459,7 +171,8 @@ public:
     GUIApp(User& u)
         : user(u), window(sf::VideoMode(900, 700), "Task Manager GUI"),
           tagFilterField(font, "Filter by tag:", 480, 10),
-          dateSortField(font, "Sort by date (asc/desc):", 480, 70) {
+          dateSortField(font, "Sort by date (asc/desc):", 480, 70),
+          reminders(static_cast<DeadlineTime>(std::time(nullptr))) {
 
         font.loadFromFile("arial.ttf");
 
@@ -496,6 +209,24 @@ public:
         calendarText.setString("Calendar Calendar View");
         calendarText.setFillColor(sf::Color::White);
         calendarText.setPosition(50, 465);
+
+        saveStatusText.setFont(font);
+        saveStatusText.setCharacterSize(14);
+        saveStatusText.setFillColor(sf::Color(100, 100, 100));
+        saveStatusText.setPosition(30, 520);
+
+        reminderText.setFont(font);
+        reminderText.setCharacterSize(14);
+        reminderText.setFillColor(sf::Color(200, 80, 0));
+        reminderText.setPosition(30, 560);
+
+        nextUpText.setFont(font);
+        nextUpText.setCharacterSize(14);
+        nextUpText.setFillColor(sf::Color(40, 40, 120));
+        nextUpText.setPosition(30, 620);
+
+        for (const Task& t : user.get_tasks()) scheduleReminder(t);
+        reminderTimer.arm(reminders.next_tick());
     }
 
     /**
@@ -521,17 +252,19 @@ public:
                 if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
                     for (size_t i = 0; i < deleteRects.size(); ++i) {
                         if (deleteRects[i].contains(event.mouseButton.x, event.mouseButton.y)) {
-                            user.delete_task(i);
-                            user.save_to_file();
-                            editingIndex = -1;
+                            user.delete_task(rowIds[i]);
+                            urgency.forget(rowIds[i]);
+                            reminders.cancel(rowIds[i]);
+                            persist();
+                            editingId = 0;
                             break;
                         }
                     }
 
                     if (saveButton.getGlobalBounds().contains(event.mouseButton.x, event.mouseButton.y)) {
-                        if (editingIndex >= 0) {
-                            updateTask(editingIndex);
-                            editingIndex = -1;
+                        if (editingId != 0) {
+                            updateTask(editingId);
+                            editingId = 0;
                         } else {
                             saveTask();
                         }
@@ -543,13 +276,33 @@ public:
 
                     for (size_t i = 0; i < taskRects.size(); ++i) {
                         if (taskRects[i].contains(event.mouseButton.x, event.mouseButton.y)) {
-                            loadTaskToForm(i);
-                            editingIndex = static_cast<int>(i);
+                            loadTaskToForm(rowIds[i]);
+                            editingId = rowIds[i];
                         }
                     }
                 }
             }
 
+            for (const auto& result : persistence.poll()) {
+                if (result.ok) {
+                    saveStatusText.setString("Saved");
+                    saveRetryDelay = std::chrono::seconds(0);
+                } else {
+                    // Журнал после сбоя не дописывается: повторяем полным снимком,
+                    // удваивая паузу, чтобы не переписывать его каждый кадр.
+                    user.request_snapshot();
+                    saveRetryDelay = std::min(std::max(saveRetryDelay * 2, std::chrono::seconds(1)),
+                                              std::chrono::seconds(60));
+                    saveRetryAt = std::chrono::steady_clock::now() + saveRetryDelay;
+                    saveStatusText.setString(result.message + ", retrying in " +
+                                             std::to_string(saveRetryDelay.count()) + " s");
+                }
+            }
+            if (saveRetryDelay.count() != 0 && std::chrono::steady_clock::now() >= saveRetryAt) {
+                saveRetryAt = std::chrono::steady_clock::time_point::max();
+                persist();
+            }
+
             window.clear(sf::Color(245, 245, 245));
             for (auto& f : fields)
                 f.draw(window);
@@ -559,11 +312,20 @@ public:
             window.draw(saveText);
             window.draw(calendarButton);
             window.draw(calendarText);
+            window.draw(saveStatusText);
+            window.draw(reminderText);
+            drawNextUp();
+
+            // Одно чтение часов на кадр; задачи пересчитываются, только если прошла их граница.
+            DeadlineTime now = static_cast<DeadlineTime>(std::time(nullptr));
+            if (reminderTimer.expired(now)) pollReminders(now);
 
             if (calendarView)
                 openCalendarWindow();
-            else
+            else {
+                urgency.advance(now);
                 drawTaskList();
+            }
 
             window.display();
         }
@@ -574,18 +336,75 @@ public:
      */
     void saveTask() {
         Task newTask = createTaskFromFields();
-        user.add_task(newTask);
-        user.save_to_file();
+        TaskId id = user.add_task(newTask);
+        scheduleReminder(*user.find_task(id));
+        persist();
     }
 
     /**
      * @brief Обновляет существующую задачу, используя данные из полей.
-     * @param index Индекс задачи, которую нужно обновить.
+     * @param id Идентификатор задачи, которую нужно обновить.
      */
-    void updateTask(int index) {
+    void updateTask(TaskId id) {
         Task updatedTask = createTaskFromFields();
-        user.edit_task(index, updatedTask);
-        user.save_to_file();
+        user.edit_task(id, updatedTask);
+        urgency.forget(id);
+        if (const Task* t = user.find_task(id)) scheduleReminder(*t);
+        persist();
+    }
+
+    /**
+     * @brief Рисует панель «Next up» — три первые задачи очереди User::next_up.
+     *
+     * Очередь поддерживается индексом, поэтому кадр читает только k задач.
+     */
+    void drawNextUp() {
+        std::string text = "Next up:";
+        for (const Task* t : user.next_up(3)) {
+            text += "\n  [" + priorityToString(t->priority) + "] " + t->title;
+            if (!t->deadline.empty()) text += " - " + t->deadline;
+        }
+        nextUpText.setString(text);
+        window.draw(nextUpText);
+    }
+
+    /**
+     * @brief Назначает напоминания задачи: только активным задачам с дедлайном.
+     * @param t Задача.
+     */
+    void scheduleReminder(const Task& t) {
+        if (t.status == Status::Active)
+            reminders.schedule(t.id, t.due);
+        else
+            reminders.cancel(t.id);
+    }
+
+    /**
+     * @brief Забирает сработавшие напоминания и заводит будильник на следующий тик.
+     * @param now Текущий момент.
+     */
+    void pollReminders(DeadlineTime now) {
+        for (const Reminder& r : reminders.advance(now)) {
+            const Task* t = user.find_task(r.id);
+            if (!t) continue;
+            reminderLog.push_front((r.kind == ReminderKind::Overdue ? "Overdue: " : "Due in 24h: ") + t->title);
+            if (reminderLog.size() > 3) reminderLog.pop_back();
+        }
+        std::string text;
+        for (const auto& line : reminderLog) text += line + "\n";
+        reminderText.setString(text);
+        reminderTimer.arm(reminders.next_tick());
+    }
+
+    /**
+     * @brief Передаёт накопленные изменения фоновому потоку сохранения.
+     *
+     * Запись на диск выполняется вне цикла отрисовки; результат
+     * забирается в run() через PersistenceWorker::poll().
+     */
+    void persist() {
+        persistence.submit(user.take_changes());
+        saveStatusText.setString("Saving...");
     }
 
     /**
@@ -601,24 +420,25 @@ public:
         Status stat = stringToStatus(fields[4].getText());
         std::string tags_raw = fields[5].getText();
 
-        std::vector<std::string> tags;
+        std::vector<TagId> tags;
         std::stringstream ss(tags_raw);
         std::string tag;
         while (std::getline(ss, tag, ',')) {
-            tags.push_back(tag);
+            tags.push_back(user.intern_tag(tag));
         }
 
         return Task{title, desc, prio, stat, deadline, tags};
     }
 
     /**
-     * @brief Загружает задачу по индексу в форму редактирования.
+     * @brief Загружает задачу по идентификатору в форму редактирования.
      * 
-     * @param index Индекс задачи в списке пользователя.
+     * @param id Идентификатор задачи.
      */
-    void loadTaskToForm(size_t index) {
-        if (index >= user.get_tasks().size()) return;
-        const Task& t = user.get_tasks()[index];
+    void loadTaskToForm(TaskId id) {
+        const Task* found = user.find_task(id);
+        if (!found) return;
+        const Task& t = *found;
         fields[0].setText(t.title);
         fields[1].setText(t.description);
         fields[2].setText(t.deadline);
@@ -626,7 +446,7 @@ public:
         fields[4].setText(statusToString(t.status));
         std::string tagStr;
         for (size_t i = 0; i < t.tags.size(); ++i) {
-            tagStr += t.tags[i];
+            tagStr += user.tags().name(t.tags[i]);
             if (i < t.tags.size() - 1) tagStr += ",";
         }
         fields[5].setText(tagStr);
@@ -635,36 +455,33 @@ public:
      * @brief Отображает список задач с учётом фильтрации по тегу и сортировки по дате.
      * 
      * Также визуализирует цветовой индикатор дедлайна и кнопки удаления.
-     * Заполняет taskRects и deleteRects для обработки нажатий мыши.
+     * Заполняет taskRects, deleteRects и rowIds для обработки нажатий мыши.
      */
     void drawTaskList() {
         taskRects.clear();
         deleteRects.clear();
-        auto tasks = user.get_tasks();
-
-        std::string tagFilter = tagFilterField.getText();
-        std::string dateOrder = dateSortField.getText();
-
-        if (dateOrder == "asc") {
-            std::sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) {
-                return a.deadline < b.deadline;
-            });
-        } else if (dateOrder == "desc") {
-            std::sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) {
-                return a.deadline > b.deadline;
-            });
-        }
-
+        rowIds.clear();
         int startY = 130;
         int x = 480;
 
-        for (size_t i = 0; i < tasks.size(); ++i) {
-            const auto& t = tasks[i];
-            if (!tagFilter.empty() && std::find(t.tags.begin(), t.tags.end(), tagFilter) == t.tags.end()) continue;
+        // Фильтр — выражение над тегами (например, "work AND NOT blocked");
+        // пока выражение некорректно (недописано), действует последнее корректное.
+        TagQuery query;
+        std::string queryError;
+        if (TagQuery::parse(tagFilterField.getText(), query, queryError)) {
+            tagFilter = std::move(query);
+        } else {
+            sf::Text errorText(queryError, font, 12);
+            errorText.setPosition(x, startY - 18);
+            errorText.setFillColor(sf::Color(200, 50, 50));
+            window.draw(errorText);
+        }
+        TaskView filtered = user.filter_by_tags(tagFilter);
 
+        auto drawRow = [&](const Task& t) {
             std::string tagStr;
             for (size_t j = 0; j < t.tags.size(); ++j) {
-                tagStr += "#" + t.tags[j];
+                tagStr += "#" + user.tags().name(t.tags[j]);
                 if (j < t.tags.size() - 1) tagStr += ", ";
             }
 
@@ -678,9 +495,12 @@ public:
 
             sf::CircleShape statusCircle(5);
             statusCircle.setPosition(x + 5, startY - scrollOffset + 5);
-            if (isOverdue(t.deadline)) {
+            if (t.deadline_invalid()) {
+                // Дедлайн не распознан при вводе или загрузке.
+                statusCircle.setFillColor(sf::Color(150, 150, 150));
+            } else if (Urgency u = urgency.classify(t.id, t.due); u == Urgency::Overdue) {
                 statusCircle.setFillColor(sf::Color::Red);
-            } else if (isUrgent(t.deadline)) {
+            } else if (u == Urgency::Urgent) {
                 statusCircle.setFillColor(sf::Color::Yellow);
             } else {
                 statusCircle.setFillColor(sf::Color::Green);
@@ -695,7 +515,19 @@ public:
 
             sf::FloatRect rect(x, startY - scrollOffset, 400, 20);
             taskRects.push_back(rect);
+            rowIds.push_back(t.id);
             startY += 24;
+        };
+
+        // Порядок по дате берётся из индекса дедлайнов: ни копий, ни сортировки.
+        std::string dateOrder = dateSortField.getText();
+        if (dateOrder == "asc" || dateOrder == "desc") {
+            DeadlineView ordered = user.tasks_by_deadline(dateOrder == "desc");
+            for (auto it = ordered.begin(); it != ordered.end(); ++it) {
+                if (filtered.positions().contains(static_cast<uint32_t>(it.slot()))) drawRow(*it);
+            }
+        } else {
+            for (const Task& t : filtered) drawRow(t);
         }
     }
     /**
@@ -709,7 +541,9 @@ public:
      * @brief Открывает отдельное окно-календарь, отображающее задачи пользователя по дням.
      * 
      * Визуализирует задачи в виде календарной сетки, где каждый день может содержать несколько задач.
-     * Календарь автоматически группирует задачи по году, месяцу и дню на основе дедлайнов.
+     * Задачи не перегруппировываются целиком: список месяцев с задачами собирается прыжками
+     * по упорядоченному индексу дедлайнов (один поиск на месяц), а задачи каждого дня
+     * показанного месяца берутся запросом диапазона User::tasks_due_between.
      * Поддерживает переключение между доступными месяцами с задачами клавишами ← / →.
      * 
      * Особенности:
@@ -721,12 +555,12 @@ public:
      * 
      * Использует:
      * - `sf::RenderWindow` для отрисовки;
-     * - `std::map` для группировки задач;
-     * - `std::tm` и `std::get_time` для разбора строк даты.
+     * - `User::tasks_due_between` для выборки задач дня;
+     * - `make_deadline` для границ дней и месяцев.
      * 
      * @note Пропускает задачи с некорректным форматом дедлайна.
      * @note Требует корректной инициализации `sf::Font font` в классе.
-     * @see User::get_tasks()
+     * @see User::tasks_due_between()
      */
     void GUIApp::openCalendarWindow() {
         sf::RenderWindow calendarWindow(sf::VideoMode(900, 700), "Task Calendar");
@@ -736,27 +570,21 @@ public:
             "July", "August", "September", "October", "November", "December"
         };
 
-        std::map<int, std::map<int, std::map<int, std::vector<Task>>>> calendarData;
-
-        for (const auto& task : user.get_tasks()) {
-            std::tm tm = {};
-            std::istringstream ss(task.deadline);
-            ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
-            if (ss.fail()) continue;
-
-            int year = tm.tm_year + 1900;
-            int month = tm.tm_mon;
-            int day = tm.tm_mday;
-            calendarData[year][month][day].push_back(task);
-        }
-
-        // Собираем все (год, месяц)
+        // Собираем все (год, месяц): берём ближайшую задачу и прыгаем к началу следующего месяца.
         std::vector<std::pair<int, int>> availableMonths;
-        for (const auto& [year, months] : calendarData)
-            for (const auto& [month, _] : months)
-                availableMonths.emplace_back(year, month);
-
-        std::sort(availableMonths.begin(), availableMonths.end());
+        DeadlineTime from = std::numeric_limits<DeadlineTime>::min();
+        while (true) {
+            DeadlineView rest = user.tasks_due_between(from, kNoDeadline);
+            if (rest.empty()) break;
+            DeadlineDate date = split_deadline(rest.begin().deadline());
+            availableMonths.emplace_back(date.year, date.month);
+            from = make_deadline(date.year, date.month + 1, 1);
+        }
+        if (availableMonths.empty()) {
+            std::time_t now = std::time(nullptr);
+            std::tm local = *std::localtime(&now);
+            availableMonths.emplace_back(local.tm_year + 1900, local.tm_mon);
+        }
         int currentIndex = 0;
 
         while (calendarWindow.isOpen()) {
@@ -810,7 +638,6 @@ public:
             }
 
             int row = 0;
-            const auto& dayMap = calendarData[year][month];
             for (int day = 1; day <= maxDays; ++day) {
                 int col = (startWeekday + day - 1) % 7;
                 row = (startWeekday + day - 1) / 7;
@@ -827,13 +654,14 @@ public:
                 label.setFillColor(sf::Color::Black);
                 calendarWindow.draw(label);
 
-                if (dayMap.count(day)) {
-                    for (size_t i = 0; i < dayMap.at(day).size(); ++i) {
-                        sf::Text t(dayMap.at(day)[i].title, font, 12);
-                        t.setFillColor(sf::Color::Black);
-                        t.setPosition(cell.getPosition().x + 5, cell.getPosition().y + 25 + i * 15);
-                        calendarWindow.draw(t);
-                    }
+                size_t i = 0;
+                for (const Task& task : user.tasks_due_between(make_deadline(year, month, day),
+                                                               make_deadline(year, month, day + 1))) {
+                    sf::Text t(task.title, font, 12);
+                    t.setFillColor(sf::Color::Black);
+                    t.setPosition(cell.getPosition().x + 5, cell.getPosition().y + 25 + i * 15);
+                    calendarWindow.draw(t);
+                    ++i;
                 }
             }
 
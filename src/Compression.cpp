@@ -0,0 +1,90 @@
+#include "Compression.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+constexpr size_t kMinMatch = 4;
+constexpr size_t kWindow = 65535;
+constexpr unsigned kHashBits = 14;
+
+uint32_t load32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void put_varint(std::string& out, size_t v) {
+    while (v >= 0x80) {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+bool get_varint(std::string_view in, size_t& pos, size_t& v) {
+    v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) return false;
+        uint8_t byte = static_cast<uint8_t>(in[pos++]);
+        v |= static_cast<size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+/// Литералы [from, to) и ссылка назад длины len (0 — конец потока).
+void emit(std::string& out, std::string_view in, size_t from, size_t to, size_t len, size_t offset) {
+    put_varint(out, to - from);
+    out.append(in.data() + from, to - from);
+    put_varint(out, len);
+    if (len != 0) put_varint(out, offset);
+}
+}
+
+std::string lz_compress(std::string_view input) {
+    std::string out;
+    out.reserve(input.size() / 2 + 16);
+    std::vector<uint32_t> table(size_t(1) << kHashBits, UINT32_MAX);
+    const char* data = input.data();
+    size_t anchor = 0;
+    size_t i = 0;
+    while (i + kMinMatch <= input.size()) {
+        const uint32_t seq = load32(data + i);
+        uint32_t& slot = table[(seq * 2654435761u) >> (32 - kHashBits)];
+        const size_t candidate = slot;
+        slot = static_cast<uint32_t>(i);
+        if (candidate == UINT32_MAX || i - candidate > kWindow || load32(data + candidate) != seq) {
+            ++i;
+            continue;
+        }
+        size_t len = kMinMatch;
+        while (i + len < input.size() && data[candidate + len] == data[i + len]) ++len;
+        emit(out, input, anchor, i, len, i - candidate);
+        i += len;
+        anchor = i;
+    }
+    emit(out, input, anchor, input.size(), 0, 0);
+    return out;
+}
+
+bool lz_decompress(std::string_view input, size_t raw_size, std::string& out) {
+    out.clear();
+    out.reserve(raw_size);
+    size_t pos = 0;
+    while (true) {
+        size_t literals = 0, len = 0, offset = 0;
+        if (!get_varint(input, pos, literals) || literals > input.size() - pos) return false;
+        if (out.size() + literals > raw_size) return false;
+        out.append(input.data() + pos, literals);
+        pos += literals;
+        if (!get_varint(input, pos, len)) return false;
+        if (len == 0) break;
+        if (!get_varint(input, pos, offset) || offset == 0 || offset > out.size()) return false;
+        if (out.size() + len > raw_size) return false;
+        // Ссылка может перекрывать сама себя — копируем по байту.
+        size_t from = out.size() - offset;
+        for (size_t k = 0; k < len; ++k) out += out[from + k];
+    }
+    return pos == input.size() && out.size() == raw_size;
+}
@@ -0,0 +1,167 @@
+#include "Deadline.h"
+#include <ctime>
+
+namespace {
+constexpr int64_t kDay = 86400;
+
+/// Дни от 1970-01-01 до даты (месяц 1..12) по пролептическому григорианскому календарю.
+constexpr int64_t days_from_civil(int64_t y, int64_t m, int64_t d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static_assert(days_from_civil(1970, 1, 1) == 0, "эпоха");
+static_assert(days_from_civil(2000, 3, 1) == 11017, "високосный век");
+
+/// Дата (месяц 1..12) по числу дней от 1970-01-01.
+void civil_from_days(int64_t z, int& year, int& month, int& day) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2));
+}
+
+/// Результат std::mktime для местного времени, записанного как UTC (секунды от эпохи).
+int64_t mktime_local(int64_t local) {
+    int64_t days = local >= 0 ? local / kDay : (local - kDay + 1) / kDay;
+    int64_t seconds = local - days * kDay;
+    int year, month, day;
+    civil_from_days(days, year, month, day);
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = static_cast<int>(seconds / 3600);
+    tm.tm_min = static_cast<int>(seconds / 60 % 60);
+    tm.tm_sec = static_cast<int>(seconds % 60);
+    return static_cast<int64_t>(std::mktime(&tm));
+}
+
+/// Смещение стандартного местного времени от UTC в момент time (через localtime_r).
+int64_t offset_at(int64_t time) {
+    const std::time_t t = static_cast<std::time_t>(time);
+    std::tm tm = {};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    const int64_t local = days_from_civil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday) * kDay +
+                          tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+    // Летнее время дедлайны не учитывают (как std::mktime с tm_isdst = 0 в parse_deadline).
+    return tm.tm_isdst > 0 ? local - mktime_local(local) : local - time;
+}
+
+/// Смещение месяца, посчитанное по его первой и последней минуте.
+struct MonthOffset {
+    int64_t key = -1;    ///< Номер месяца year * 12 + month - 1.
+    int64_t offset = 0;  ///< Смещение в секундах.
+    bool stable = false; ///< Смещение одно на весь месяц.
+};
+
+/**
+ * Смещение стандартного местного времени от UTC для месяца.
+ * std::mktime берёт блокировки часового пояса, поэтому смещение считается
+ * один раз на месяц и кэшируется в потоке.
+ * @param year Год.
+ * @param month Месяц 1..12.
+ */
+const MonthOffset& month_offset(int year, int month) {
+    thread_local MonthOffset cache[256];
+    const int64_t key = static_cast<int64_t>(year) * 12 + month - 1;
+    MonthOffset& e = cache[static_cast<uint64_t>(key) % 256];
+    if (e.key != key) {
+        const int64_t first = days_from_civil(year, month, 1) * kDay;
+        const int64_t next = days_from_civil(year + (month == 12), month % 12 + 1, 1) * kDay - 60;
+        e.key = key;
+        e.offset = first - mktime_local(first);
+        e.stable = next - mktime_local(next) == e.offset;
+    }
+    return e;
+}
+
+/**
+ * Смещение стандартного местного времени от UTC в секундах для местного
+ * времени local. Если смещение в начале и в конце месяца разное (пояс сменил
+ * стандартное время), для такого месяца каждый раз вызывается std::mktime.
+ * @param year Год.
+ * @param month Месяц 1..12.
+ * @param local Местное время, записанное как UTC.
+ */
+int64_t local_offset(int year, int month, int64_t local) {
+    const MonthOffset& e = month_offset(year, month);
+    return e.stable ? e.offset : local - mktime_local(local);
+}
+
+/// Значение двух цифр; в bad попадают биты, если символ не цифра.
+inline unsigned two_digits(const char* p, unsigned& bad) {
+    const unsigned hi = static_cast<unsigned char>(p[0]) - '0';
+    const unsigned lo = static_cast<unsigned char>(p[1]) - '0';
+    bad |= (hi > 9) | (lo > 9);
+    return hi * 10 + lo;
+}
+}
+
+DeadlineTime parse_deadline(std::string_view text) {
+    if (text.size() != 16) return kNoDeadline;
+    const char* s = text.data();
+    unsigned bad = (s[4] != '-') | (s[7] != '-') | (s[10] != ' ') | (s[13] != ':');
+    const unsigned year = two_digits(s, bad) * 100 + two_digits(s + 2, bad);
+    const unsigned month = two_digits(s + 5, bad);
+    const unsigned day = two_digits(s + 8, bad);
+    const unsigned hour = two_digits(s + 11, bad);
+    const unsigned minute = two_digits(s + 14, bad);
+
+    const unsigned leap = (year % 4 == 0) & ((year % 100 != 0) | (year % 400 == 0));
+    // 31 день в январе, марте, мае, июле, августе, октябре и декабре.
+    const unsigned month_days = month == 2 ? 28 + leap : 30 + ((month + (month >> 3)) & 1);
+    bad |= (month - 1 > 11) | (day - 1 >= month_days) | (hour > 23) | (minute > 59);
+    if (bad) return kNoDeadline;
+
+    const int64_t local = days_from_civil(year, month, day) * kDay + hour * 3600 + minute * 60;
+    return local - local_offset(static_cast<int>(year), static_cast<int>(month), local);
+}
+
+DeadlineTime make_deadline(int year, int month, int day, int hour, int minute) {
+    // Нормализуем месяц, остальное переполнение уходит в сумму секунд.
+    int64_t y = year + (month >= 0 ? month / 12 : (month - 11) / 12);
+    int64_t m = month - (y - year) * 12;
+    const int64_t local = (days_from_civil(y, m + 1, 1) + day - 1) * kDay + hour * 3600 + minute * 60;
+    const int64_t days = local >= 0 ? local / kDay : (local - kDay + 1) / kDay;
+    int real_year, real_month, real_day;
+    civil_from_days(days, real_year, real_month, real_day);
+    return local - local_offset(real_year, real_month, local);
+}
+
+DeadlineDate split_deadline(DeadlineTime time) {
+    DeadlineDate date;
+    // Смещение месяца по UTC годится, если оно постоянно весь месяц и местное
+    // время попало в тот же месяц; иначе (смена пояса, граница месяца)
+    // смещение считается для самого момента.
+    int64_t utc_days = time >= 0 ? time / kDay : (time - kDay + 1) / kDay;
+    civil_from_days(utc_days, date.year, date.month, date.day);
+    const MonthOffset& e = month_offset(date.year, date.month);
+    int64_t local = time + e.offset;
+    int64_t days = local >= 0 ? local / kDay : (local - kDay + 1) / kDay;
+    const int utc_month = date.month;
+    civil_from_days(days, date.year, date.month, date.day);
+    if (!e.stable || date.month != utc_month) {
+        local = time + offset_at(time);
+        days = local >= 0 ? local / kDay : (local - kDay + 1) / kDay;
+        civil_from_days(days, date.year, date.month, date.day);
+    }
+    int64_t seconds = local - days * kDay;
+    date.month -= 1;
+    date.hour = static_cast<int>(seconds / 3600);
+    date.minute = static_cast<int>(seconds / 60 % 60);
+    return date;
+}
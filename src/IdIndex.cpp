@@ -0,0 +1,131 @@
+#include "IdIndex.h"
+#if !defined(__GNUC__) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace {
+// Насколько позиций вперёд build() запрашивает ячейки в кэш.
+constexpr size_t kPrefetchAhead = 16;
+
+// Перемешивание из splitmix64: последовательные id расходятся по всей таблице.
+uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+void prefetch(const void* p) {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#elif defined(_M_X64) || defined(_M_IX86)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+}
+
+size_t IdIndex::home(uint64_t id) const {
+    return static_cast<size_t>(mix(id)) & (entries.size() - 1);
+}
+
+void IdIndex::rehash(size_t capacity) {
+    std::vector<Entry> old;
+    old.swap(entries);
+    entries.assign(capacity, Entry());
+    count = 0;
+    for (const Entry& e : old) {
+        if (e.id != 0) insert(e.id, e.slot);
+    }
+}
+
+void IdIndex::reserve(size_t n) {
+    size_t capacity = 16;
+    // Заполненность держим не выше 3/4.
+    while (capacity * 3 < n * 4) capacity *= 2;
+    if (capacity > entries.size()) rehash(capacity);
+}
+
+void IdIndex::insert(uint64_t id, size_t slot) {
+    if ((count + 1) * 4 > entries.size() * 3) reserve(count + 1);
+    size_t mask = entries.size() - 1;
+    for (size_t i = home(id);; i = (i + 1) & mask) {
+        if (entries[i].id == id) {
+            entries[i].slot = slot;
+            return;
+        }
+        if (entries[i].id == 0) {
+            entries[i] = Entry{id, slot};
+            ++count;
+            return;
+        }
+    }
+}
+
+std::vector<size_t> IdIndex::build(const std::vector<uint64_t>& ids) {
+    if (count != 0) clear();
+    reserve(ids.size());
+    std::vector<size_t> rejected;
+    const size_t mask = entries.size() - 1;
+    for (size_t slot = 0; slot < ids.size(); ++slot) {
+        if (slot + kPrefetchAhead < ids.size()) prefetch(&entries[home(ids[slot + kPrefetchAhead])]);
+        const uint64_t id = ids[slot];
+        if (id == 0) {
+            rejected.push_back(slot);
+            continue;
+        }
+        for (size_t i = home(id);; i = (i + 1) & mask) {
+            if (entries[i].id == id) {
+                rejected.push_back(slot);
+                break;
+            }
+            if (entries[i].id == 0) {
+                entries[i] = Entry{id, slot};
+                ++count;
+                break;
+            }
+        }
+    }
+    return rejected;
+}
+
+size_t IdIndex::find(uint64_t id) const {
+    if (entries.empty() || id == 0) return npos;
+    size_t mask = entries.size() - 1;
+    for (size_t i = home(id);; i = (i + 1) & mask) {
+        if (entries[i].id == id) return entries[i].slot;
+        if (entries[i].id == 0) return npos;
+    }
+}
+
+bool IdIndex::erase(uint64_t id) {
+    if (entries.empty() || id == 0) return false;
+    size_t mask = entries.size() - 1;
+    size_t i = home(id);
+    while (entries[i].id != id) {
+        if (entries[i].id == 0) return false;
+        i = (i + 1) & mask;
+    }
+
+    // Сдвигаем назад элементы, чья цепочка проходит через освободившуюся ячейку.
+    size_t hole = i;
+    for (size_t j = (hole + 1) & mask; entries[j].id != 0; j = (j + 1) & mask) {
+        size_t h = home(entries[j].id);
+        bool reachable = hole <= j ? (h <= hole || h > j) : (h <= hole && h > j);
+        if (reachable) {
+            entries[hole] = entries[j];
+            hole = j;
+        }
+    }
+    entries[hole] = Entry();
+    --count;
+    return true;
+}
+
+void IdIndex::clear() {
+    entries.clear();
+    count = 0;
+}
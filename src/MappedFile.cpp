@@ -0,0 +1,54 @@
+#include "MappedFile.h"
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    bytes = static_cast<const char*>(p);
+    length = static_cast<size_t>(st.st_size);
+    mapped = true;
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    std::streamsize n = file.tellg();
+    if (n <= 0) return false;
+    buffer.resize(static_cast<size_t>(n));
+    file.seekg(0);
+    if (!file.read(buffer.data(), n)) return false;
+    bytes = buffer.data();
+    length = buffer.size();
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped) munmap(const_cast<char*>(bytes), length);
+#endif
+    buffer.clear();
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+}
@@ -0,0 +1,22 @@
+#include "PersistBatch.h"
+#include "TaskLog.h"
+#include "TaskSnapshot.h"
+
+void PersistBatch::merge(PersistBatch&& next) {
+    if (next.snapshot || empty()) {
+        *this = std::move(next);
+        return;
+    }
+    records += next.records;
+    record_count += next.record_count;
+}
+
+bool PersistBatch::write() const {
+    TaskLog log(log_path);
+    if (snapshot) {
+        // Журнал очищается, только когда снимок уже на диске (см. TaskSnapshot::write).
+        if (!TaskSnapshot::write(snapshot_path, TaskRange(tasks, task_count), tags, seq)) return false;
+        if (!log.truncate()) return false;
+    }
+    return log.append(records, record_count);
+}
@@ -0,0 +1,80 @@
+#include "PersistenceWorker.h"
+#include <algorithm>
+
+PersistenceWorker::PersistenceWorker(std::chrono::milliseconds debounce,
+                                     std::chrono::milliseconds max_delay)
+    : debounce(debounce), max_delay(max_delay), worker(&PersistenceWorker::run, this) {}
+
+PersistenceWorker::~PersistenceWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void PersistenceWorker::submit(PersistBatch batch) {
+    if (batch.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = Clock::now();
+        if (queued.empty()) first_submit = now;
+        last_submit = now;
+        queued.merge(std::move(batch));
+    }
+    wake.notify_all();
+}
+
+void PersistenceWorker::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    flushing = true;
+    wake.notify_all();
+    idle.wait(lock, [&] { return queued.empty() && !writing; });
+    flushing = false;
+}
+
+std::vector<PersistenceWorker::Result> PersistenceWorker::poll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Result> out;
+    out.swap(results);
+    return out;
+}
+
+void PersistenceWorker::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || !queued.empty(); });
+        if (queued.empty()) break;
+
+        // Ждём паузы в правках, но не дольше max_delay с первой из них.
+        while (!stopping && !flushing) {
+            auto due = std::min(last_submit + debounce, first_submit + max_delay);
+            if (Clock::now() >= due) break;
+            wake.wait_until(lock, due);
+        }
+
+        PersistBatch batch = std::move(queued);
+        queued = PersistBatch();
+        writing = true;
+        lock.unlock();
+
+        const bool skipped = log_broken && !batch.snapshot;
+        bool ok = !skipped && batch.write();
+
+        lock.lock();
+        writing = false;
+        if (!ok) log_broken = true;
+        else if (batch.snapshot) log_broken = false;
+        Result result;
+        result.ok = ok;
+        if (skipped) {
+            result.message = "Save postponed until a full snapshot is written";
+        } else if (!ok) {
+            result.message = "Failed to save " + (batch.snapshot ? batch.snapshot_path : batch.log_path);
+        }
+        results.push_back(std::move(result));
+        if (queued.empty()) idle.notify_all();
+    }
+    idle.notify_all();
+}
@@ -0,0 +1,48 @@
+#include "ReminderTimer.h"
+
+#ifdef __linux__
+#include <cstdint>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+ReminderTimer::ReminderTimer() {
+#ifdef __linux__
+    fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+#endif
+}
+
+ReminderTimer::~ReminderTimer() {
+#ifdef __linux__
+    if (fd >= 0) close(fd);
+#endif
+}
+
+void ReminderTimer::arm(DeadlineTime at) {
+    armed = at;
+#ifdef __linux__
+    if (fd < 0) return;
+    itimerspec spec = {};
+    spec.it_value.tv_sec = static_cast<time_t>(at);
+    if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+        // Без timerfd остаётся сравнение с текущим временем.
+        close(fd);
+        fd = -1;
+    }
+#endif
+}
+
+bool ReminderTimer::expired(DeadlineTime now) {
+    if (armed == kNoDeadline) return false;
+#ifdef __linux__
+    if (fd >= 0) {
+        uint64_t ticks = 0;
+        if (read(fd, &ticks, sizeof(ticks)) != sizeof(ticks) || ticks == 0) return false;
+        armed = kNoDeadline;
+        return true;
+    }
+#endif
+    if (now < armed) return false;
+    armed = kNoDeadline;
+    return true;
+}
@@ -0,0 +1,99 @@
+#include "ReminderWheel.h"
+
+namespace {
+constexpr int64_t kHour = 60;          // тиков в часе
+constexpr int64_t kDay = 24 * kHour;   // тиков в сутках
+constexpr int64_t kYear = 366 * kDay;  // тиков в колесе дней
+constexpr DeadlineTime kDueSoonWindow = 86400;
+
+int64_t floor_tick(DeadlineTime t) {
+    return t >= 0 ? t / ReminderWheel::kTick : (t - ReminderWheel::kTick + 1) / ReminderWheel::kTick;
+}
+}
+
+ReminderWheel::ReminderWheel(DeadlineTime now) : tick(floor_tick(now)) {}
+
+bool ReminderWheel::alive(const Timer& timer) const {
+    auto it = owners.find(timer.reminder.id);
+    return it != owners.end() && it->second.generation == timer.generation;
+}
+
+void ReminderWheel::place(Timer timer) {
+    const int64_t delta = timer.expires - tick;
+    if (delta < kHour) {
+        minutes[timer.expires % 60].push_back(timer);
+    } else if (delta < kDay) {
+        hours[timer.expires / kHour % 24].push_back(timer);
+    } else if (delta < kYear) {
+        days[timer.expires / kDay % 366].push_back(timer);
+    } else {
+        overflow.push_back(timer);
+    }
+}
+
+void ReminderWheel::schedule(TaskId id, DeadlineTime due) {
+    cancel(id);
+    if (due == kNoDeadline) return;
+    const DeadlineTime now = tick * kTick;
+    Owner owner{next_generation++, 0};
+    for (Reminder r : {Reminder{id, ReminderKind::DueSoon, due - kDueSoonWindow},
+                       Reminder{id, ReminderKind::Overdue, due}}) {
+        if (r.at <= now) continue;
+        // Первый тик, на котором момент уже наступил.
+        place(Timer{floor_tick(r.at + kTick - 1), owner.generation, r});
+        ++owner.live;
+    }
+    if (owner.live == 0) return;
+    owners[id] = owner;
+    live += owner.live;
+}
+
+void ReminderWheel::cancel(TaskId id) {
+    auto it = owners.find(id);
+    if (it == owners.end()) return;
+    live -= it->second.live;
+    owners.erase(it);
+}
+
+void ReminderWheel::cascade(std::vector<Timer>& slot) {
+    std::vector<Timer> moved;
+    moved.swap(slot);
+    for (const Timer& t : moved) {
+        if (alive(t)) place(t);
+    }
+}
+
+void ReminderWheel::step(std::vector<Reminder>& fired) {
+    ++tick;
+    // Сначала старшие колёса: их таймеры могут попасть в текущую минуту.
+    if (tick % kYear == 0) cascade(overflow);
+    if (tick % kDay == 0) cascade(days[tick / kDay % 366]);
+    if (tick % kHour == 0) cascade(hours[tick / kHour % 24]);
+    std::vector<Timer>& slot = minutes[tick % 60];
+    for (const Timer& t : slot) {
+        if (!alive(t)) continue;
+        fired.push_back(t.reminder);
+        auto owner = owners.find(t.reminder.id);
+        --live;
+        if (--owner->second.live == 0) owners.erase(owner);
+    }
+    slot.clear();
+}
+
+std::vector<Reminder> ReminderWheel::advance(DeadlineTime now) {
+    std::vector<Reminder> fired;
+    const int64_t target = floor_tick(now);
+    while (tick < target) {
+        if (live == 0) {
+            // Ждать нечего (например, после сна системы) — перескакиваем сразу.
+            for (auto& slot : minutes) slot.clear();
+            for (auto& slot : hours) slot.clear();
+            for (auto& slot : days) slot.clear();
+            overflow.clear();
+            tick = target;
+            break;
+        }
+        step(fired);
+    }
+    return fired;
+}
@@ -0,0 +1,338 @@
+#include "RoaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+// Больше стольких элементов массив занимает больше места, чем битовая карта (8 КБ).
+constexpr uint32_t kArrayMax = 4096;
+constexpr size_t kWords = 65536 / 64;
+}
+
+bool RoaringBitmap::Container::contains(uint16_t low) const {
+    if (is_bitmap()) return (bits[low >> 6] >> (low & 63)) & 1;
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+void RoaringBitmap::Container::to_bitmap() {
+    bits.assign(kWords, 0);
+    for (uint16_t low : array) bits[low >> 6] |= uint64_t{1} << (low & 63);
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void RoaringBitmap::Container::to_array() {
+    array.clear();
+    array.reserve(cardinality);
+    for (size_t w = 0; w < bits.size(); ++w) {
+        uint64_t word = bits[w];
+        while (word != 0) {
+            array.push_back(static_cast<uint16_t>(w * 64 + trailing_zeros(word)));
+            word &= word - 1;
+        }
+    }
+    bits.clear();
+    bits.shrink_to_fit();
+}
+
+void RoaringBitmap::Container::normalize() {
+    if (is_bitmap() && cardinality <= kArrayMax) to_array();
+    else if (!is_bitmap() && cardinality > kArrayMax) to_bitmap();
+}
+
+size_t RoaringBitmap::lower_bound(uint16_t key) const {
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    return static_cast<size_t>(it - containers.begin());
+}
+
+bool RoaringBitmap::add(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    size_t i = lower_bound(key);
+    if (i == containers.size() || containers[i].key != key) {
+        Container c;
+        c.key = key;
+        containers.insert(containers.begin() + static_cast<std::ptrdiff_t>(i), std::move(c));
+    }
+    Container& c = containers[i];
+    if (c.is_bitmap()) {
+        uint64_t& word = c.bits[low >> 6];
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (word & mask) return false;
+        word |= mask;
+    } else {
+        auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (it != c.array.end() && *it == low) return false;
+        c.array.insert(it, low);
+    }
+    ++c.cardinality;
+    c.normalize();
+    return true;
+}
+
+void RoaringBitmap::append(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    if (containers.empty() || containers.back().key < key) {
+        Container c;
+        c.key = key;
+        containers.push_back(std::move(c));
+    } else if (containers.back().key > key) {
+        add(value);
+        return;
+    }
+    Container& c = containers.back();
+    if (c.is_bitmap()) {
+        uint64_t& word = c.bits[low >> 6];
+        const uint64_t mask = uint64_t{1} << (low & 63);
+        if (word & mask) return;
+        word |= mask;
+    } else if (c.array.empty() || c.array.back() < low) {
+        c.array.push_back(low);
+    } else {
+        add(value);
+        return;
+    }
+    if (++c.cardinality > kArrayMax && !c.is_bitmap()) c.to_bitmap();
+}
+
+RoaringBitmap RoaringBitmap::from_words(const std::vector<uint64_t>& words) {
+    RoaringBitmap result;
+    for (size_t first = 0; first < words.size(); first += kWords) {
+        const size_t last = std::min(first + kWords, words.size());
+        uint32_t cardinality = 0;
+        for (size_t w = first; w < last; ++w) cardinality += popcount(words[w]);
+        if (cardinality == 0) continue;
+        Container c;
+        c.key = static_cast<uint16_t>(first / kWords);
+        c.cardinality = cardinality;
+        c.bits.assign(kWords, 0);
+        std::copy(words.begin() + static_cast<std::ptrdiff_t>(first), words.begin() + static_cast<std::ptrdiff_t>(last),
+                  c.bits.begin());
+        c.normalize();
+        result.containers.push_back(std::move(c));
+    }
+    return result;
+}
+
+bool RoaringBitmap::remove(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    size_t i = lower_bound(key);
+    if (i == containers.size() || containers[i].key != key) return false;
+    Container& c = containers[i];
+    if (c.is_bitmap()) {
+        uint64_t& word = c.bits[low >> 6];
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (!(word & mask)) return false;
+        word &= ~mask;
+    } else {
+        auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (it == c.array.end() || *it != low) return false;
+        c.array.erase(it);
+    }
+    if (--c.cardinality == 0) {
+        containers.erase(containers.begin() + static_cast<std::ptrdiff_t>(i));
+    } else {
+        c.normalize();
+    }
+    return true;
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    size_t i = lower_bound(key);
+    return i < containers.size() && containers[i].key == key &&
+           containers[i].contains(static_cast<uint16_t>(value & 0xFFFF));
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const Container& c : containers) total += c.cardinality;
+    return total;
+}
+
+void RoaringBitmap::intersect(Container& a, const Container& b) {
+    if (a.is_bitmap() && b.is_bitmap()) {
+        uint32_t card = 0;
+        for (size_t w = 0; w < kWords; ++w) {
+            a.bits[w] &= b.bits[w];
+            card += popcount(a.bits[w]);
+        }
+        a.cardinality = card;
+    } else if (a.is_bitmap()) {
+        // Результат не больше массива b — строим его сразу массивом.
+        std::vector<uint16_t> out;
+        out.reserve(b.array.size());
+        for (uint16_t low : b.array) {
+            if (a.contains(low)) out.push_back(low);
+        }
+        a.bits.clear();
+        a.bits.shrink_to_fit();
+        a.array = std::move(out);
+        a.cardinality = static_cast<uint32_t>(a.array.size());
+    } else if (b.is_bitmap()) {
+        auto end = std::remove_if(a.array.begin(), a.array.end(),
+                                  [&](uint16_t low) { return !b.contains(low); });
+        a.array.erase(end, a.array.end());
+        a.cardinality = static_cast<uint32_t>(a.array.size());
+    } else {
+        std::vector<uint16_t> out;
+        out.reserve(std::min(a.array.size(), b.array.size()));
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(out));
+        a.array = std::move(out);
+        a.cardinality = static_cast<uint32_t>(a.array.size());
+    }
+    a.normalize();
+}
+
+void RoaringBitmap::unite(Container& a, const Container& b) {
+    if (!a.is_bitmap() && !b.is_bitmap() && a.array.size() + b.array.size() <= kArrayMax) {
+        std::vector<uint16_t> out;
+        out.reserve(a.array.size() + b.array.size());
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(out));
+        a.array = std::move(out);
+        a.cardinality = static_cast<uint32_t>(a.array.size());
+        return;
+    }
+    if (!a.is_bitmap()) a.to_bitmap();
+    if (b.is_bitmap()) {
+        for (size_t w = 0; w < kWords; ++w) a.bits[w] |= b.bits[w];
+    } else {
+        for (uint16_t low : b.array) a.bits[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    uint32_t card = 0;
+    for (uint64_t word : a.bits) card += popcount(word);
+    a.cardinality = card;
+    a.normalize();
+}
+
+void RoaringBitmap::subtract(Container& a, const Container& b) {
+    if (a.is_bitmap()) {
+        if (b.is_bitmap()) {
+            for (size_t w = 0; w < kWords; ++w) a.bits[w] &= ~b.bits[w];
+        } else {
+            for (uint16_t low : b.array) a.bits[low >> 6] &= ~(uint64_t{1} << (low & 63));
+        }
+        uint32_t card = 0;
+        for (uint64_t word : a.bits) card += popcount(word);
+        a.cardinality = card;
+    } else if (b.is_bitmap()) {
+        auto end = std::remove_if(a.array.begin(), a.array.end(),
+                                  [&](uint16_t low) { return b.contains(low); });
+        a.array.erase(end, a.array.end());
+        a.cardinality = static_cast<uint32_t>(a.array.size());
+    } else {
+        std::vector<uint16_t> out;
+        out.reserve(a.array.size());
+        std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                            std::back_inserter(out));
+        a.array = std::move(out);
+        a.cardinality = static_cast<uint32_t>(a.array.size());
+    }
+    a.normalize();
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& other) {
+    std::vector<Container> out;
+    size_t j = 0;
+    for (Container& c : containers) {
+        while (j < other.containers.size() && other.containers[j].key < c.key) ++j;
+        if (j == other.containers.size()) break;
+        if (other.containers[j].key != c.key) continue;
+        intersect(c, other.containers[j]);
+        if (c.cardinality != 0) out.push_back(std::move(c));
+    }
+    containers = std::move(out);
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other) {
+    std::vector<Container> out;
+    out.reserve(containers.size() + other.containers.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < containers.size() || j < other.containers.size()) {
+        if (j == other.containers.size() ||
+            (i < containers.size() && containers[i].key < other.containers[j].key)) {
+            out.push_back(std::move(containers[i++]));
+        } else if (i == containers.size() || other.containers[j].key < containers[i].key) {
+            out.push_back(other.containers[j++]);
+        } else {
+            unite(containers[i], other.containers[j++]);
+            out.push_back(std::move(containers[i++]));
+        }
+    }
+    containers = std::move(out);
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator-=(const RoaringBitmap& other) {
+    std::vector<Container> out;
+    out.reserve(containers.size());
+    size_t j = 0;
+    for (Container& c : containers) {
+        while (j < other.containers.size() && other.containers[j].key < c.key) ++j;
+        if (j < other.containers.size() && other.containers[j].key == c.key) {
+            subtract(c, other.containers[j]);
+            if (c.cardinality == 0) continue;
+        }
+        out.push_back(std::move(c));
+    }
+    containers = std::move(out);
+    return *this;
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap& other) const {
+    if (containers.size() != other.containers.size()) return false;
+    for (size_t i = 0; i < containers.size(); ++i) {
+        const Container& a = containers[i];
+        const Container& b = other.containers[i];
+        // Представление блока однозначно определяется его мощностью.
+        if (a.key != b.key || a.cardinality != b.cardinality || a.array != b.array || a.bits != b.bits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint32_t> RoaringBitmap::to_vector() const {
+    std::vector<uint32_t> out;
+    out.reserve(static_cast<size_t>(cardinality()));
+    for_each([&](uint32_t v) { out.push_back(v); });
+    return out;
+}
+
+void RoaringBitmap::const_iterator::start() {
+    pos = 0;
+    word = 0;
+    if (container >= owner->containers.size()) return;
+    const Container& c = owner->containers[container];
+    if (!c.is_bitmap()) return;
+    // Блок непустой, поэтому ненулевое слово найдётся.
+    while (c.bits[pos] == 0) ++pos;
+    word = c.bits[pos];
+}
+
+uint32_t RoaringBitmap::const_iterator::operator*() const {
+    const Container& c = owner->containers[container];
+    const uint32_t high = static_cast<uint32_t>(c.key) << 16;
+    if (c.is_bitmap()) return high | static_cast<uint32_t>(pos * 64 + trailing_zeros(word));
+    return high | c.array[pos];
+}
+
+RoaringBitmap::const_iterator& RoaringBitmap::const_iterator::operator++() {
+    const Container& c = owner->containers[container];
+    if (c.is_bitmap()) {
+        word &= word - 1;
+        while (word == 0 && ++pos < kWords) word = c.bits[pos];
+        if (word != 0) return *this;
+    } else if (++pos < c.array.size()) {
+        return *this;
+    }
+    ++container;
+    start();
+    return *this;
+}
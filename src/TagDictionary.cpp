@@ -0,0 +1,37 @@
+#include "TagDictionary.h"
+
+TagId TagDictionary::intern(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
+    TagId id = static_cast<TagId>(names_.size());
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+}
+
+TagId TagDictionary::find(const std::string& name) const {
+    auto it = ids_.find(name);
+    return it == ids_.end() ? npos : it->second;
+}
+
+std::vector<std::string> TagDictionary::names(const std::vector<TagId>& ids) const {
+    std::vector<std::string> result;
+    result.reserve(ids.size());
+    for (TagId id : ids) result.push_back(names_[id]);
+    return result;
+}
+
+bool TagDictionary::rename(const std::string& from, const std::string& to) {
+    auto it = ids_.find(from);
+    if (it == ids_.end() || ids_.count(to) != 0) return false;
+    TagId id = it->second;
+    ids_.erase(it);
+    ids_.emplace(to, id);
+    names_[id] = to;
+    return true;
+}
+
+void TagDictionary::clear() {
+    names_.clear();
+    ids_.clear();
+}
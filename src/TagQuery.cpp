@@ -0,0 +1,170 @@
+#include "TagQuery.h"
+#include <cctype>
+
+/// Разбор рекурсивным спуском: expr := term (OR term)*, term := factor (AND factor)*,
+/// factor := NOT factor | '(' expr ')' | тег.
+class TagQuery::Parser {
+public:
+    Parser(const std::string& text, std::vector<Node>& nodes) : text(text), nodes(nodes) { next(); }
+
+    int expression() {
+        int left = term();
+        while (left >= 0 && token == "OR" && !quoted) {
+            next();
+            left = join(Node::Kind::Or, left, term());
+        }
+        return left;
+    }
+
+    bool at_end() const { return token.empty() && !quoted; }
+    const std::string& error() const { return error_; }
+
+private:
+    int term() {
+        int left = factor();
+        while (left >= 0 && token == "AND" && !quoted) {
+            next();
+            left = join(Node::Kind::And, left, factor());
+        }
+        return left;
+    }
+
+    int factor() {
+        if (!error_.empty()) return -1;
+        if (!quoted && token == "NOT") {
+            next();
+            int operand = factor();
+            if (operand < 0) return -1;
+            nodes.push_back(Node{Node::Kind::Not, {}, operand, -1});
+            return static_cast<int>(nodes.size()) - 1;
+        }
+        if (!quoted && token == "(") {
+            next();
+            int inner = expression();
+            if (inner < 0) return -1;
+            if (quoted || token != ")") return fail("expected ')'");
+            next();
+            return inner;
+        }
+        if (at_end()) return fail("expected tag");
+        if (!quoted && (token == ")" || token == "AND" || token == "OR")) return fail("unexpected '" + token + "'");
+        nodes.push_back(Node{Node::Kind::Tag, token, -1, -1});
+        next();
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    int join(Node::Kind kind, int left, int right) {
+        if (right < 0) return -1;
+        nodes.push_back(Node{kind, {}, left, right});
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    int fail(const std::string& message) {
+        if (error_.empty()) error_ = message + " at position " + std::to_string(start);
+        return -1;
+    }
+
+    void next() {
+        token.clear();
+        quoted = false;
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+        start = pos;
+        if (pos == text.size()) return;
+        char c = text[pos];
+        if (c == '(' || c == ')') {
+            token = c;
+            ++pos;
+        } else if (c == '"') {
+            size_t close = text.find('"', pos + 1);
+            if (close == std::string::npos) {
+                fail("unterminated quote");
+                pos = text.size();
+                return;
+            }
+            token = text.substr(pos + 1, close - pos - 1);
+            quoted = true;
+            pos = close + 1;
+        } else {
+            while (pos < text.size() && !std::isspace(static_cast<unsigned char>(text[pos])) &&
+                   text[pos] != '(' && text[pos] != ')' && text[pos] != '"') {
+                token += text[pos++];
+            }
+        }
+    }
+
+    const std::string& text;
+    std::vector<Node>& nodes;
+    size_t pos = 0;      ///< Позиция разбора.
+    size_t start = 0;    ///< Начало текущей лексемы.
+    std::string token;   ///< Текущая лексема.
+    bool quoted = false; ///< Лексема была в кавычках (не ключевое слово).
+    std::string error_;  ///< Описание ошибки.
+};
+
+bool TagQuery::parse(const std::string& text, TagQuery& out, std::string& error) {
+    std::vector<Node> nodes;
+    Parser parser(text, nodes);
+    if (parser.at_end() && parser.error().empty()) {
+        out.nodes.clear();
+        return true;
+    }
+    int root = parser.expression();
+    if (root >= 0 && !parser.at_end()) {
+        error = "unexpected text after expression";
+        return false;
+    }
+    if (root < 0) {
+        error = parser.error();
+        return false;
+    }
+    // Узлы добавляются после своих операндов, так что корень — последний.
+    out.nodes = std::move(nodes);
+    return true;
+}
+
+RoaringBitmap TagQuery::evaluate(const TaskStore& store, const TagDictionary& dictionary) const {
+    if (nodes.empty()) return store.live_slots();
+    return eval(static_cast<int>(nodes.size()) - 1, store, dictionary);
+}
+
+RoaringBitmap TagQuery::eval(int index, const TaskStore& store, const TagDictionary& dictionary) const {
+    const Node& node = nodes[index];
+    // Правый операнд-тег берём по ссылке из хранилища, не копируя множество.
+    auto operand = [&](int i, RoaringBitmap& scratch) -> const RoaringBitmap& {
+        if (nodes[i].kind != Node::Kind::Tag) return scratch = eval(i, store, dictionary);
+        TagId id = dictionary.find(nodes[i].tag);
+        return id == TagDictionary::npos ? scratch : store.tag_slots(id);
+    };
+    RoaringBitmap scratch;
+    switch (node.kind) {
+        case Node::Kind::Tag: {
+            TagId id = dictionary.find(node.tag);
+            return id == TagDictionary::npos ? RoaringBitmap() : store.tag_slots(id);
+        }
+        case Node::Kind::Not:
+            return store.live_slots() - operand(node.left, scratch);
+        case Node::Kind::And: {
+            // a AND NOT b считаем разностью, не строя дополнение b.
+            const Node& l = nodes[node.left];
+            const Node& r = nodes[node.right];
+            RoaringBitmap result;
+            if (r.kind == Node::Kind::Not) {
+                result = eval(node.left, store, dictionary);
+                result -= operand(r.left, scratch);
+            } else if (l.kind == Node::Kind::Not) {
+                result = eval(node.right, store, dictionary);
+                result -= operand(l.left, scratch);
+            } else {
+                result = eval(node.left, store, dictionary);
+                result &= operand(node.right, scratch);
+            }
+            return result;
+        }
+        case Node::Kind::Or: {
+            RoaringBitmap result = eval(node.left, store, dictionary);
+            result |= operand(node.right, scratch);
+            return result;
+        }
+    }
+    return RoaringBitmap();
+}
@@ -0,0 +1,46 @@
+#include "Task.h"
+
+std::string priorityToString(Priority p) {
+    switch (p) {
+        case Priority::Low: return "Low";
+        case Priority::Medium: return "Medium";
+        case Priority::High: return "High";
+    }
+    return "Unknown";
+}
+
+std::string statusToString(Status s) {
+    return s == Status::Active ? "Active" : "Done";
+}
+
+Priority stringToPriority(const std::string& str) {
+    if (str == "Low") return Priority::Low;
+    if (str == "Medium") return Priority::Medium;
+    return Priority::High;
+}
+
+Status stringToStatus(const std::string& str) {
+    return str == "Active" ? Status::Active : Status::Done;
+}
+
+json Task::to_json(const TagDictionary& dictionary) const {
+    return json{{"id", id},
+                {"title", title},
+                {"description", description},
+                {"priority", priorityToString(priority)},
+                {"status", statusToString(status)},
+                {"deadline", deadline},
+                {"tags", dictionary.names(tags)}};
+}
+
+Task Task::from_json(const json& j, TagDictionary& dictionary) {
+    Task t;
+    t.id = j.value("id", TaskId{0});
+    t.title = j.at("title").get<std::string>();
+    t.description = j.at("description").get<std::string>();
+    t.priority = stringToPriority(j.at("priority"));
+    t.status = stringToStatus(j.at("status"));
+    t.set_deadline(j.at("deadline").get<std::string>());
+    for (const auto& tag : j.at("tags")) t.tags.push_back(dictionary.intern(tag.get<std::string>()));
+    return t;
+}
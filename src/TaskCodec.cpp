@@ -0,0 +1,96 @@
+#include "TaskCodec.h"
+#include "TaskSaxLoader.h"
+#include "TaskJsonWriter.h"
+#include <ostream>
+
+namespace {
+
+template <typename Range>
+json to_array(const Range& tasks, const TagDictionary& dictionary) {
+    json items = json::array();
+    for (const auto& t : tasks) items.push_back(t.to_json(dictionary));
+    return items;
+}
+
+void write_bytes(const std::vector<std::uint8_t>& bytes, std::ostream& out) {
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+class JsonCodec : public TaskCodec {
+public:
+    const char* name() const override { return "json"; }
+    const char* extension() const override { return ".json"; }
+
+    void encode(const std::vector<Task>& tasks, const TagDictionary& dictionary,
+                std::ostream& out) const override {
+        TaskJsonWriter writer(out, dictionary);
+        writer.write_array(tasks);
+    }
+
+    void encode(const TaskRange& tasks, const TagDictionary& dictionary, std::ostream& out) const override {
+        TaskJsonWriter writer(out, dictionary);
+        writer.write_array(tasks);
+    }
+
+    bool decode(std::istream& in, TaskSaxLoader& loader) const override {
+        return loader.load(in, json::input_format_t::json);
+    }
+};
+
+class CborCodec : public TaskCodec {
+public:
+    const char* name() const override { return "cbor"; }
+    const char* extension() const override { return ".cbor"; }
+
+    void encode(const std::vector<Task>& tasks, const TagDictionary& dictionary,
+                std::ostream& out) const override {
+        write_bytes(json::to_cbor(to_array(tasks, dictionary)), out);
+    }
+
+    void encode(const TaskRange& tasks, const TagDictionary& dictionary, std::ostream& out) const override {
+        write_bytes(json::to_cbor(to_array(tasks, dictionary)), out);
+    }
+
+    bool decode(std::istream& in, TaskSaxLoader& loader) const override {
+        return loader.load(in, json::input_format_t::cbor);
+    }
+};
+
+class MsgPackCodec : public TaskCodec {
+public:
+    const char* name() const override { return "msgpack"; }
+    const char* extension() const override { return ".msgpack"; }
+
+    void encode(const std::vector<Task>& tasks, const TagDictionary& dictionary,
+                std::ostream& out) const override {
+        write_bytes(json::to_msgpack(to_array(tasks, dictionary)), out);
+    }
+
+    void encode(const TaskRange& tasks, const TagDictionary& dictionary, std::ostream& out) const override {
+        write_bytes(json::to_msgpack(to_array(tasks, dictionary)), out);
+    }
+
+    bool decode(std::istream& in, TaskSaxLoader& loader) const override {
+        return loader.load(in, json::input_format_t::msgpack);
+    }
+};
+
+}
+
+const std::vector<const TaskCodec*>& TaskCodec::all() {
+    static const JsonCodec jsonCodec;
+    static const CborCodec cborCodec;
+    static const MsgPackCodec msgpackCodec;
+    static const std::vector<const TaskCodec*> codecs = {&jsonCodec, &cborCodec, &msgpackCodec};
+    return codecs;
+}
+
+const TaskCodec* TaskCodec::for_path(const std::string& path) {
+    for (const TaskCodec* codec : all()) {
+        std::string ext = codec->extension();
+        if (path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0) {
+            return codec;
+        }
+    }
+    return nullptr;
+}
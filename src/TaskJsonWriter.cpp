@@ -0,0 +1,123 @@
+#include "TaskJsonWriter.h"
+#include <ostream>
+
+namespace {
+const char kHex[] = "0123456789abcdef";
+
+const char* priorityName(Priority p) {
+    switch (p) {
+        case Priority::Low: return "\"Low\"";
+        case Priority::Medium: return "\"Medium\"";
+        case Priority::High: return "\"High\"";
+    }
+    return "\"Unknown\"";
+}
+
+const char* statusName(Status s) {
+    return s == Status::Active ? "\"Active\"" : "\"Done\"";
+}
+}
+
+TaskJsonWriter::TaskJsonWriter(std::ostream& out, const TagDictionary& dictionary, size_t buffer_size)
+    : out(out), dictionary(dictionary), limit(buffer_size) {
+    // Запас на одну задачу сверх порога, чтобы буфер не перевыделялся.
+    buffer.reserve(limit + 4096);
+}
+
+TaskJsonWriter::~TaskJsonWriter() {
+    flush();
+}
+
+void TaskJsonWriter::flush() {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+void TaskJsonWriter::reserve_for(size_t bytes) {
+    if (buffer.size() + bytes > buffer.capacity()) flush();
+}
+
+void TaskJsonWriter::put(char c) {
+    reserve_for(1);
+    buffer.push_back(c);
+}
+
+void TaskJsonWriter::write_array(const std::vector<Task>& tasks) {
+    write_range(tasks);
+}
+
+void TaskJsonWriter::write_array(const TaskRange& tasks) {
+    write_range(tasks);
+}
+
+template <typename Range>
+void TaskJsonWriter::write_range(const Range& tasks) {
+    put('[');
+    bool first = true;
+    for (const Task& t : tasks) {
+        if (!first) put(',');
+        first = false;
+        write_task(t);
+    }
+    put(']');
+}
+
+void TaskJsonWriter::write_task(const Task& t) {
+    // Порядок ключей как в nlohmann::json: объекты хранятся в std::map.
+    buffer += "{\"deadline\":";
+    write_string(t.deadline);
+    buffer += ",\"description\":";
+    write_string(t.description);
+    buffer += ",\"id\":";
+    write_number(t.id);
+    buffer += ",\"priority\":";
+    buffer += priorityName(t.priority);
+    buffer += ",\"status\":";
+    buffer += statusName(t.status);
+    buffer += ",\"tags\":[";
+    for (size_t i = 0; i < t.tags.size(); ++i) {
+        if (i > 0) buffer += ',';
+        write_string(dictionary.name(t.tags[i]));
+    }
+    buffer += "],\"title\":";
+    write_string(t.title);
+    buffer += '}';
+    if (buffer.size() >= limit) flush();
+}
+
+void TaskJsonWriter::write_number(uint64_t value) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (n > 0) buffer += digits[--n];
+}
+
+void TaskJsonWriter::write_string(const std::string& s) {
+    // Худший случай — каждый байт превращается в \u00XX.
+    reserve_for(s.size() * 6 + 2);
+    buffer += '"';
+    for (char ch : s) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+            case '"': buffer += "\\\""; break;
+            case '\\': buffer += "\\\\"; break;
+            case '\b': buffer += "\\b"; break;
+            case '\f': buffer += "\\f"; break;
+            case '\n': buffer += "\\n"; break;
+            case '\r': buffer += "\\r"; break;
+            case '\t': buffer += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    buffer += "\\u00";
+                    buffer += kHex[c >> 4];
+                    buffer += kHex[c & 0xF];
+                } else {
+                    buffer += ch;
+                }
+        }
+    }
+    buffer += '"';
+}
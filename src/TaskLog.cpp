@@ -0,0 +1,89 @@
+#include "TaskLog.h"
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define log_open _open
+#define log_write _write
+#define log_sync _commit
+#define log_close _close
+#else
+#include <unistd.h>
+#define log_open open
+#define log_write write
+#define log_sync fsync
+#define log_close close
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+TaskLog::TaskLog(const std::string& path) : path(path) {}
+
+bool TaskLog::append(const std::string& lines, size_t count) {
+    if (lines.empty()) return true;
+    int fd = log_open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_BINARY, 0644);
+    if (fd < 0) return false;
+
+    const char* data = lines.data();
+    size_t left = lines.size();
+    while (left > 0) {
+        auto written = log_write(fd, data, static_cast<unsigned>(left));
+        if (written <= 0) {
+            log_close(fd);
+            return false;
+        }
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    bool ok = log_sync(fd) == 0;
+    log_close(fd);
+    records += count;
+    return ok;
+}
+
+size_t TaskLog::replay(const std::function<bool(const json&)>& apply) {
+    records = 0;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return 0;
+
+    std::string line;
+    std::streamoff good = 0;
+    bool torn = false;
+    while (std::getline(file, line)) {
+        // Строка без '\n' в конце файла — оборванная запись, её не применяем.
+        if (file.eof()) {
+            torn = true;
+            break;
+        }
+        // Целая, но испорченная строка — не сбой записи: за ней могут быть
+        // настоящие изменения, поэтому файл не трогаем.
+        json record = json::parse(line, nullptr, false);
+        if (record.is_discarded() || !apply(record)) {
+            throw std::runtime_error(path + ": invalid record on line " + std::to_string(records + 1));
+        }
+        ++records;
+        good = file.tellg();
+    }
+    file.close();
+
+    // Отрезаем хвост, чтобы новые записи не оказались за повреждённой строкой.
+    if (torn) {
+        std::error_code ec;
+        std::filesystem::resize_file(path, static_cast<std::uintmax_t>(good), ec);
+    }
+    return records;
+}
+
+bool TaskLog::truncate() {
+    int fd = log_open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    if (fd < 0) return false;
+    bool ok = log_sync(fd) == 0;
+    log_close(fd);
+    records = 0;
+    return ok;
+}
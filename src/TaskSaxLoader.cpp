@@ -0,0 +1,123 @@
+#include "TaskSaxLoader.h"
+#include <istream>
+
+namespace {
+constexpr unsigned bit(int f) { return 1u << f; }
+// Поля, без которых задача считается неполной (как в Task::from_json).
+constexpr unsigned kRequired = bit(1) | bit(2) | bit(3) | bit(4) | bit(5) | bit(6);
+}
+
+TaskSaxLoader::TaskSaxLoader(std::vector<Task>& out, TagDictionary& dictionary)
+    : tasks(out), dictionary(dictionary) {}
+
+bool TaskSaxLoader::load(std::istream& in, json::input_format_t format) {
+    return json::sax_parse(in, this, format);
+}
+
+bool TaskSaxLoader::null() {
+    return true;
+}
+
+bool TaskSaxLoader::boolean(bool) {
+    return true;
+}
+
+bool TaskSaxLoader::number_integer(number_integer_t) {
+    return true;
+}
+
+bool TaskSaxLoader::number_unsigned(number_unsigned_t val) {
+    if (in_task() && field == Field::Id) current.id = val;
+    if (wrapped && depth == 1 && rootKey == "seq") seq_ = val;
+    return true;
+}
+
+bool TaskSaxLoader::number_float(number_float_t, const string_t&) {
+    return true;
+}
+
+bool TaskSaxLoader::string(string_t& val) {
+    if (in_tags()) {
+        current.tags.push_back(dictionary.intern(val));
+        return true;
+    }
+    if (!in_task()) return true;
+
+    switch (field) {
+        case Field::Title: current.title = std::move(val); break;
+        case Field::Description: current.description = std::move(val); break;
+        case Field::Priority: current.priority = stringToPriority(val); break;
+        case Field::Status: current.status = stringToStatus(val); break;
+        case Field::Deadline: current.set_deadline(std::move(val)); break;
+        default: return true;
+    }
+    seen |= bit(static_cast<int>(field));
+    return true;
+}
+
+bool TaskSaxLoader::binary(binary_t&) {
+    return true;
+}
+
+bool TaskSaxLoader::start_object(std::size_t) {
+    ++depth;
+    if (depth == 1) {
+        wrapped = true;
+    } else if (depth == arrayDepth + 1) {
+        current = Task();
+        seen = 0;
+        field = Field::Other;
+        inTask = true;
+    }
+    return true;
+}
+
+bool TaskSaxLoader::key(string_t& val) {
+    if (in_task()) {
+        if (val == "title") field = Field::Title;
+        else if (val == "description") field = Field::Description;
+        else if (val == "priority") field = Field::Priority;
+        else if (val == "status") field = Field::Status;
+        else if (val == "deadline") field = Field::Deadline;
+        else if (val == "tags") field = Field::Tags;
+        else if (val == "id") field = Field::Id;
+        else field = Field::Other;
+    } else if (wrapped && depth == 1) {
+        rootKey = val;
+    }
+    return true;
+}
+
+bool TaskSaxLoader::end_object() {
+    if (in_task()) {
+        if ((seen & kRequired) != kRequired) {
+            error_ = "task #" + std::to_string(tasks.size()) + " is missing required fields";
+            return false;
+        }
+        tasks.push_back(std::move(current));
+        inTask = false;
+    }
+    --depth;
+    return true;
+}
+
+bool TaskSaxLoader::start_array(std::size_t) {
+    ++depth;
+    if (depth == 1 || (wrapped && depth == 2 && rootKey == "tasks")) {
+        arrayDepth = depth;
+    } else if (in_tags()) {
+        seen |= bit(static_cast<int>(Field::Tags));
+    }
+    return true;
+}
+
+bool TaskSaxLoader::end_array() {
+    --depth;
+    return true;
+}
+
+bool TaskSaxLoader::parse_error(std::size_t, const std::string&,
+                                const nlohmann::detail::exception& ex) {
+    error_ = ex.what();
+    return false;
+}
@@ -0,0 +1,268 @@
+#include "TaskSnapshot.h"
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define snap_open _open
+#define snap_write _write
+#define snap_sync _commit
+#define snap_close _close
+#else
+#include <unistd.h>
+#define snap_open ::open
+#define snap_write ::write
+#define snap_sync ::fsync
+#define snap_close ::close
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+namespace {
+constexpr char kMagic[8] = {'T', 'M', 'S', 'N', 'A', 'P', '\0', '\0'};
+// Версия 2: в записи задачи появился идентификатор.
+// Версия 3: имена тегов хранятся один раз, задачи ссылаются на них номерами.
+constexpr uint32_t kVersion = 3;
+constexpr uint32_t kUnused = static_cast<uint32_t>(-1);
+constexpr uint32_t kByteOrder = 0x01020304;
+
+uint64_t put(std::string& heap, const std::string& s) {
+    uint64_t offset = heap.size();
+    heap += s;
+    return offset;
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        auto written = snap_write(fd, p, static_cast<unsigned>(size));
+        if (written <= 0) return false;
+        p += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/// Отрезок [off, off + len) лежит внутри [0, size); сумма не вычисляется,
+/// поэтому смещение из повреждённого файла не может переполниться.
+bool inside(uint64_t off, uint64_t len, uint64_t size) {
+    return off <= size && len <= size - off;
+}
+
+// Переименование попадает на диск только вместе с каталогом. На Windows
+// каталог так не открыть; там хватает _commit самого файла.
+bool sync_directory(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+#endif
+}
+}
+
+bool TaskSnapshot::write(const std::string& path, const std::vector<Task>& tasks,
+                         const TagDictionary& dictionary, uint64_t seq) {
+    return write_range(path, tasks, tasks.size(), dictionary, seq);
+}
+
+bool TaskSnapshot::write(const std::string& path, const TaskRange& tasks,
+                         const TagDictionary& dictionary, uint64_t seq) {
+    return write_range(path, tasks, tasks.size(), dictionary, seq);
+}
+
+template <typename Range>
+bool TaskSnapshot::write_range(const std::string& path, const Range& tasks, size_t count,
+                               const TagDictionary& dictionary, uint64_t seq) {
+    std::vector<Record> table(count);
+    std::vector<TagRef> nameTable;
+    std::vector<uint32_t> tagTable;
+    std::vector<uint32_t> number(dictionary.size(), kUnused);
+    std::string heap;
+
+    size_t i = 0;
+    for (const Task& t : tasks) {
+        Record& r = table[i++];
+        std::memset(&r, 0, sizeof(r));
+        r.id = t.id;
+        r.title = put(heap, t.title);
+        r.title_len = static_cast<uint32_t>(t.title.size());
+        r.description = put(heap, t.description);
+        r.description_len = static_cast<uint32_t>(t.description.size());
+        r.deadline = put(heap, t.deadline);
+        r.deadline_len = static_cast<uint32_t>(t.deadline.size());
+        r.first_tag = tagTable.size();
+        r.tag_count = static_cast<uint32_t>(t.tags.size());
+        r.priority = static_cast<uint8_t>(t.priority);
+        r.status = static_cast<uint8_t>(t.status);
+        for (TagId tag : t.tags) {
+            // Имя попадает в таблицу при первом использовании.
+            if (number[tag] == kUnused) {
+                const std::string& name = dictionary.name(tag);
+                number[tag] = static_cast<uint32_t>(nameTable.size());
+                nameTable.push_back(TagRef{put(heap, name), static_cast<uint32_t>(name.size()), 0});
+            }
+            tagTable.push_back(number[tag]);
+        }
+    }
+
+    Header h;
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.byte_order = kByteOrder;
+    h.seq = seq;
+    h.task_count = table.size();
+    h.name_count = nameTable.size();
+    h.tag_count = tagTable.size();
+    h.heap_size = heap.size();
+
+    // Временный файл сбрасывается на диск до переименования, а каталог — после:
+    // иначе после сбоя питания на месте снимка может оказаться пустой файл,
+    // хотя журнал с теми же данными уже очищен.
+    const std::string tmp = path + ".tmp";
+    int fd = snap_open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    if (fd < 0) return false;
+    bool ok = write_all(fd, &h, sizeof(h)) &&
+              write_all(fd, table.data(), table.size() * sizeof(Record)) &&
+              write_all(fd, nameTable.data(), nameTable.size() * sizeof(TagRef)) &&
+              write_all(fd, tagTable.data(), tagTable.size() * sizeof(uint32_t)) &&
+              write_all(fd, heap.data(), heap.size()) && snap_sync(fd) == 0;
+    snap_close(fd);
+    if (!ok) return false;
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    return !ec && sync_directory(path);
+}
+
+bool TaskSnapshot::open(const std::string& path) {
+    header = nullptr;
+    if (!file.open(path)) return false;
+    if (file.size() < sizeof(Header)) return false;
+
+    const Header* h = reinterpret_cast<const Header*>(file.data());
+    if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 ||
+        h->version != kVersion || h->byte_order != kByteOrder) {
+        return false;
+    }
+
+    // Проверяем, что таблицы и куча целиком лежат внутри файла.
+    if (h->task_count > file.size() || h->name_count > file.size() ||
+        h->tag_count > file.size() || h->heap_size > file.size()) {
+        return false;
+    }
+    uint64_t expected = sizeof(Header) + h->task_count * sizeof(Record) + h->name_count * sizeof(TagRef) +
+                        h->tag_count * sizeof(uint32_t) + h->heap_size;
+    if (expected != file.size()) return false;
+
+    const char* base = file.data() + sizeof(Header);
+    records = reinterpret_cast<const Record*>(base);
+    names = reinterpret_cast<const TagRef*>(base + h->task_count * sizeof(Record));
+    tags = reinterpret_cast<const uint32_t*>(names + h->name_count);
+    heap = reinterpret_cast<const char*>(tags + h->tag_count);
+
+    for (uint64_t i = 0; i < h->task_count; ++i) {
+        const Record& r = records[i];
+        if (!inside(r.title, r.title_len, h->heap_size) ||
+            !inside(r.description, r.description_len, h->heap_size) ||
+            !inside(r.deadline, r.deadline_len, h->heap_size) ||
+            !inside(r.first_tag, r.tag_count, h->tag_count) ||
+            r.priority > static_cast<uint8_t>(Priority::High) ||
+            r.status > static_cast<uint8_t>(Status::Done)) {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < h->name_count; ++i) {
+        if (!inside(names[i].offset, names[i].length, h->heap_size)) return false;
+    }
+    for (uint64_t i = 0; i < h->tag_count; ++i) {
+        if (tags[i] >= h->name_count) return false;
+    }
+
+    header = h;
+    return true;
+}
+
+size_t TaskSnapshot::size() const {
+    return header ? static_cast<size_t>(header->task_count) : 0;
+}
+
+uint64_t TaskSnapshot::seq() const {
+    return header ? header->seq : 0;
+}
+
+std::string_view TaskSnapshot::str(uint64_t offset, uint32_t length) const {
+    return std::string_view(heap + offset, length);
+}
+
+TaskId TaskSnapshot::id(size_t i) const {
+    return records[i].id;
+}
+
+std::string_view TaskSnapshot::title(size_t i) const {
+    return str(records[i].title, records[i].title_len);
+}
+
+std::string_view TaskSnapshot::description(size_t i) const {
+    return str(records[i].description, records[i].description_len);
+}
+
+std::string_view TaskSnapshot::deadline(size_t i) const {
+    return str(records[i].deadline, records[i].deadline_len);
+}
+
+Priority TaskSnapshot::priority(size_t i) const {
+    return static_cast<Priority>(records[i].priority);
+}
+
+Status TaskSnapshot::status(size_t i) const {
+    return static_cast<Status>(records[i].status);
+}
+
+size_t TaskSnapshot::tag_count(size_t i) const {
+    return records[i].tag_count;
+}
+
+std::string_view TaskSnapshot::tag(size_t i, size_t k) const {
+    return name(tag_index(i, k));
+}
+
+uint32_t TaskSnapshot::tag_index(size_t i, size_t k) const {
+    return tags[records[i].first_tag + k];
+}
+
+size_t TaskSnapshot::name_count() const {
+    return header ? static_cast<size_t>(header->name_count) : 0;
+}
+
+std::string_view TaskSnapshot::name(size_t n) const {
+    return str(names[n].offset, names[n].length);
+}
+
+std::vector<TagId> TaskSnapshot::intern_names(TagDictionary& dictionary) const {
+    std::vector<TagId> ids(name_count());
+    for (size_t n = 0; n < ids.size(); ++n) ids[n] = dictionary.intern(std::string(name(n)));
+    return ids;
+}
+
+Task TaskSnapshot::task(size_t i, const std::vector<TagId>& tag_ids) const {
+    Task t;
+    t.id = id(i);
+    t.title = title(i);
+    t.description = description(i);
+    t.set_deadline(std::string(deadline(i)));
+    t.priority = priority(i);
+    t.status = status(i);
+    t.tags.reserve(tag_count(i));
+    const uint32_t* first = tags + records[i].first_tag;
+    for (size_t k = 0; k < tag_count(i); ++k) t.tags.push_back(tag_ids[first[k]]);
+    return t;
+}
@@ -0,0 +1,358 @@
+#include "TaskStore.h"
+#include "TaskSnapshot.h"
+#include <algorithm>
+
+namespace {
+// Небольшие списки не уплотняем: надгробий в них просто мало.
+constexpr size_t kMinCompactSlots = 64;
+const RoaringBitmap kNoSlots;
+}
+
+const RoaringBitmap& TaskStore::tag_slots(TagId tag) const {
+    return tag < by_tag.size() ? by_tag[tag] : kNoSlots;
+}
+
+void TaskStore::index_slot(size_t slot, const Task& task) {
+    const uint32_t pos = static_cast<uint32_t>(slot);
+    for (TagId tag : task.tags) {
+        if (tag >= by_tag.size()) by_tag.resize(tag + 1);
+        by_tag[tag].add(pos);
+    }
+    by_status[static_cast<size_t>(task.status)].add(pos);
+    by_priority[static_cast<size_t>(task.priority)].add(pos);
+    alive.add(pos);
+}
+
+void TaskStore::unindex_slot(size_t slot, const Task& task) {
+    const uint32_t pos = static_cast<uint32_t>(slot);
+    for (TagId tag : task.tags) by_tag[tag].remove(pos);
+    by_status[static_cast<size_t>(task.status)].remove(pos);
+    by_priority[static_cast<size_t>(task.priority)].remove(pos);
+    alive.remove(pos);
+}
+
+void TaskStore::count(const Task& task, int delta) {
+    priority_counts[static_cast<size_t>(task.priority)] += delta;
+    // Пока упорядоченных индексов нет, календарь тоже не ведётся: build_orders() соберёт его целиком.
+    if (!ordered) return;
+    auto it = calendar.emplace(task.deadline, 0).first;
+    // Нулевые записи удаляем: сводка должна совпадать с полным пересчётом.
+    if ((it->second += delta) == 0) calendar.erase(it);
+}
+
+const Task& TaskStore::tombstone() {
+    static const Task empty;
+    return empty;
+}
+
+TaskStore::NextKey TaskStore::next_key(size_t slot) const {
+    // Приоритет инвертирован, чтобы High шёл первым.
+    return NextKey(statuses[slot], static_cast<uint8_t>(2 - static_cast<uint8_t>(priorities[slot])),
+                   deadlines[slot], ids[slot]);
+}
+
+void TaskStore::load(size_t slot) const {
+    Task task = source->task(slot, source_tags);
+    // Повтор или нулевой идентификатор из снимка мог получить новый.
+    task.id = ids[slot];
+    cold.set(slot, make_task_handle(std::move(task)));
+    if (--unloaded == 0) {
+        // Все записи собраны — отображение снимка больше не нужно.
+        source.reset();
+        source_tags = {};
+    }
+}
+
+void TaskStore::load_all() const {
+    for (size_t slot = 0; unloaded != 0 && slot < ids.size(); ++slot) {
+        if (ids[slot] != 0 && !cold[slot]) load(slot);
+    }
+}
+
+void TaskStore::build_orders() const {
+    if (ordered) return;
+    std::string key;
+    for (size_t slot = 0; slot < ids.size(); ++slot) {
+        if (ids[slot] == 0) continue;
+        by_deadline.emplace(deadlines[slot], ids[slot]);
+        by_next.insert(next_key(slot));
+        // Календарю нужна только строка дедлайна — несобранную запись читаем из снимка.
+        key.assign(cold[slot] ? std::string_view(cold[slot]->deadline) : source->deadline(slot));
+        ++calendar[key];
+    }
+    ordered = true;
+}
+
+void TaskStore::push(TaskHandle task) {
+    ids.push_back(0);
+    priorities.push_back(task->priority);
+    statuses.push_back(task->status);
+    deadlines.push_back(kNoDeadline);
+    cold.push_back(nullptr);
+    fill(cold.size() - 1, std::move(task));
+}
+
+void TaskStore::push_tombstone() {
+    ids.push_back(0);
+    priorities.push_back(Priority::Low);
+    statuses.push_back(Status::Active);
+    deadlines.push_back(kNoDeadline);
+    cold.push_back(nullptr);
+}
+
+void TaskStore::fill(size_t slot, TaskHandle task) {
+    const Task& t = *task;
+    ids[slot] = t.id;
+    priorities[slot] = t.priority;
+    statuses[slot] = t.status;
+    deadlines[slot] = t.due;
+    index.insert(t.id, slot);
+    index_slot(slot, t);
+    count(t, +1);
+    if (ordered) {
+        by_deadline.emplace(t.due, t.id);
+        by_next.insert(next_key(slot));
+    }
+    cold.set(slot, std::move(task));
+    ++live;
+}
+
+void TaskStore::revive(size_t slot, TaskHandle task) {
+    if (task->id == 0 || index.find(task->id) != IdIndex::npos || slot >= ids.size() || ids[slot] != 0) {
+        insert(*task);
+        return;
+    }
+    next_id = std::max(next_id, task->id + 1);
+    fill(slot, std::move(task));
+}
+
+TaskId TaskStore::add(Task task) {
+    task.id = next_id++;
+    TaskId id = task.id;
+    push(make_task_handle(std::move(task)));
+    return id;
+}
+
+TaskId TaskStore::insert(Task task) {
+    if (task.id == 0 || index.find(task.id) != IdIndex::npos) task.id = next_id;
+    next_id = std::max(next_id, task.id + 1);
+    TaskId id = task.id;
+    push(make_task_handle(std::move(task)));
+    return id;
+}
+
+void TaskStore::assign(size_t slot, Task task) {
+    task.id = ids[slot];
+    replace(slot, make_task_handle(std::move(task)));
+}
+
+void TaskStore::assign(size_t slot, TaskHandle task) {
+    if (task->id != ids[slot]) {
+        assign(slot, Task(*task));
+        return;
+    }
+    replace(slot, std::move(task));
+}
+
+void TaskStore::replace(size_t slot, TaskHandle task) {
+    const Task& next = *task;
+    const Task& prev = record(slot);
+    const NextKey old_next = next_key(slot);
+    priorities[slot] = next.priority;
+    statuses[slot] = next.status;
+    if (next.due != deadlines[slot]) {
+        if (ordered) {
+            by_deadline.erase(DeadlineKey(deadlines[slot], next.id));
+            by_deadline.emplace(next.due, next.id);
+        }
+        deadlines[slot] = next.due;
+    }
+    const NextKey new_next = next_key(slot);
+    if (ordered && old_next != new_next) {
+        by_next.erase(old_next);
+        by_next.insert(new_next);
+    }
+    unindex_slot(slot, prev);
+    index_slot(slot, next);
+    count(prev, -1);
+    count(next, +1);
+    cold.set(slot, std::move(task));
+}
+
+void TaskStore::erase(size_t slot) {
+    const Task& prev = record(slot);
+    index.erase(ids[slot]);
+    unindex_slot(slot, prev);
+    count(prev, -1);
+    if (ordered) {
+        by_deadline.erase(DeadlineKey(deadlines[slot], ids[slot]));
+        by_next.erase(next_key(slot));
+    }
+    ids[slot] = 0;
+    cold.set(slot, nullptr);
+    --live;
+    if (ids.size() >= kMinCompactSlots && (ids.size() - live) * 2 > ids.size()) compact();
+}
+
+void TaskStore::compact() {
+    // Позиции сдвигаются, поэтому множества собираются заново, а записи снимка — сразу:
+    // ленивая сборка опирается на совпадение позиции с номером записи в снимке.
+    load_all();
+    clear_sets();
+    TaskTable packed;
+    size_t out = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (ids[i] == 0) continue;
+        if (out != i) {
+            ids[out] = ids[i];
+            priorities[out] = priorities[i];
+            statuses[out] = statuses[i];
+            deadlines[out] = deadlines[i];
+            index.insert(ids[out], out);
+        }
+        packed.push_back(cold.take(i));
+        index_slot(out, *packed[out]);
+        ++out;
+    }
+    ids.resize(out);
+    priorities.resize(out);
+    statuses.resize(out);
+    deadlines.resize(out);
+    cold = std::move(packed);
+}
+
+bool TaskStore::restore(std::vector<Task> records, bool assign_missing) {
+    bool assigned = false;
+    TaskId keep_next = next_id;
+    clear();
+    next_id = keep_next;
+    reserve(records.size());
+    for (const auto& t : records) next_id = std::max(next_id, t.id + 1);
+    for (auto& t : records) {
+        if (t.id == 0 && !assign_missing) {
+            // Надгробие: сохраняем позицию, чтобы порядок остался прежним.
+            push_tombstone();
+            continue;
+        }
+        // Задачи из старых файлов приходят без идентификаторов.
+        if (t.id == 0 || index.find(t.id) != IdIndex::npos) {
+            t.id = next_id++;
+            assigned = true;
+        }
+        push(make_task_handle(std::move(t)));
+    }
+    return assigned;
+}
+
+bool TaskStore::restore(std::shared_ptr<const TaskSnapshot> snapshot, std::vector<TagId> tag_ids) {
+    bool assigned = false;
+    TaskId keep_next = next_id;
+    clear();
+    next_id = keep_next;
+    const size_t n = snapshot->size();
+    reserve(n);
+    ordered = false;
+    // Множества статусов и приоритетов плотные: сначала простые битовые строки, затем блоки целиком.
+    std::vector<uint64_t> status_words[2], priority_words[3];
+    for (auto& words : status_words) words.assign((n + 63) / 64, 0);
+    for (auto& words : priority_words) words.assign((n + 63) / 64, 0);
+    for (size_t i = 0; i < n; ++i) {
+        const TaskId id = snapshot->id(i);
+        const Priority priority = snapshot->priority(i);
+        const Status status = snapshot->status(i);
+        const uint32_t pos = static_cast<uint32_t>(i);
+        const uint64_t bit = uint64_t{1} << (i & 63);
+        next_id = std::max(next_id, id + 1);
+        ids.push_back(id);
+        priorities.push_back(priority);
+        statuses.push_back(status);
+        deadlines.push_back(parse_deadline(snapshot->deadline(i)));
+        // Позиции идут по возрастанию, поэтому множества тегов только дописываются.
+        for (size_t k = 0; k < snapshot->tag_count(i); ++k) {
+            const TagId tag = tag_ids[snapshot->tag_index(i, k)];
+            if (tag >= by_tag.size()) by_tag.resize(tag + 1);
+            by_tag[tag].append(pos);
+        }
+        status_words[static_cast<size_t>(status)][i >> 6] |= bit;
+        priority_words[static_cast<size_t>(priority)][i >> 6] |= bit;
+        ++priority_counts[static_cast<size_t>(priority)];
+    }
+    for (size_t s = 0; s < 2; ++s) by_status[s] = RoaringBitmap::from_words(status_words[s]);
+    for (size_t p = 0; p < 3; ++p) by_priority[p] = RoaringBitmap::from_words(priority_words[p]);
+    alive = by_status[0] | by_status[1];
+    // Ручки задач появятся при первом обращении к записям (load()).
+    cold.assign(n, nullptr);
+    // Нулевые и повторные идентификаторы получают новые.
+    for (size_t slot : index.build(ids)) {
+        ids[slot] = next_id++;
+        index.insert(ids[slot], slot);
+        assigned = true;
+    }
+    live = n;
+    unloaded = n;
+    if (n != 0) {
+        source = std::move(snapshot);
+        source_tags = std::move(tag_ids);
+    }
+    return assigned;
+}
+
+bool TaskStore::restore(const TaskTable& records) {
+    bool assigned = false;
+    TaskId keep_next = next_id;
+    clear();
+    next_id = keep_next;
+    reserve(records.size());
+    for (const TaskHandle& t : records) {
+        if (t) next_id = std::max(next_id, t->id + 1);
+    }
+    for (const TaskHandle& t : records) {
+        if (!t || t->id == 0) {
+            push_tombstone();
+        } else if (index.find(t->id) != IdIndex::npos) {
+            // Повтор получает новый идентификатор — только ему нужна своя копия.
+            Task copy = *t;
+            copy.id = next_id++;
+            assigned = true;
+            push(make_task_handle(std::move(copy)));
+        } else {
+            push(t);
+        }
+    }
+    return assigned;
+}
+
+void TaskStore::clear() {
+    ids.clear();
+    priorities.clear();
+    statuses.clear();
+    deadlines.clear();
+    cold.clear();
+    index.clear();
+    clear_sets();
+    for (int& n : priority_counts) n = 0;
+    calendar.clear();
+    by_deadline.clear();
+    by_next.clear();
+    ordered = true;
+    live = 0;
+    next_id = 1;
+    source.reset();
+    source_tags.clear();
+    unloaded = 0;
+}
+
+void TaskStore::clear_sets() {
+    by_tag.clear();
+    for (auto& slots : by_status) slots.clear();
+    for (auto& slots : by_priority) slots.clear();
+    alive.clear();
+}
+
+void TaskStore::reserve(size_t count) {
+    ids.reserve(count);
+    priorities.reserve(count);
+    statuses.reserve(count);
+    deadlines.reserve(count);
+    index.reserve(count);
+}
@@ -0,0 +1,253 @@
+#include "UndoHistory.h"
+#include "Compression.h"
+#include <cstring>
+#include <filesystem>
+
+namespace {
+/// Память строки вне объекта (0, если строка во встроенном буфере).
+size_t heap_bytes(const std::string& s) {
+    const char* data = s.data();
+    const char* self = reinterpret_cast<const char*>(&s);
+    if (data >= self && data < self + sizeof(s)) return 0;
+    return s.capacity() + 1;
+}
+
+/// Динамическая память задачи сверх sizeof(Task).
+size_t task_heap_bytes(const Task& t) {
+    return heap_bytes(t.title) + heap_bytes(t.description) + heap_bytes(t.deadline) +
+           t.tags.capacity() * sizeof(TagId);
+}
+
+/// Память задачи за ручкой. Считается всегда: даже если задачу сейчас держит
+/// и хранилище, после её правки или удаления останется только запись истории.
+size_t handle_bytes(const TaskHandle& t) {
+    return t ? sizeof(Task) + task_heap_bytes(*t) : 0;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put_string(std::string& out, const std::string& s) {
+    put(out, static_cast<uint32_t>(s.size()));
+    out += s;
+}
+
+void put_task(std::string& out, const Task& t) {
+    put(out, t.id);
+    put_string(out, t.title);
+    put_string(out, t.description);
+    put_string(out, t.deadline);
+    put(out, static_cast<uint8_t>(t.priority));
+    put(out, static_cast<uint8_t>(t.status));
+    put(out, static_cast<uint32_t>(t.tags.size()));
+    // Номера тегов не меняются (переименование правит только словарь), поэтому пишутся как есть.
+    for (TagId tag : t.tags) put(out, tag);
+}
+
+/// Последовательное чтение сериализованной записи с проверкой границ.
+struct Reader {
+    std::string_view in;
+    size_t pos = 0;
+
+    template <typename T>
+    bool get(T& value) {
+        if (in.size() - pos < sizeof(T)) return false;
+        std::memcpy(&value, in.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool get_string(std::string& s) {
+        uint32_t len = 0;
+        if (!get(len) || in.size() - pos < len) return false;
+        s.assign(in.data() + pos, len);
+        pos += len;
+        return true;
+    }
+
+    bool get_task(Task& t) {
+        uint8_t priority = 0, status = 0;
+        uint32_t tag_count = 0;
+        std::string deadline;
+        if (!get(t.id) || !get_string(t.title) || !get_string(t.description) || !get_string(deadline) ||
+            !get(priority) || !get(status) || !get(tag_count) || priority > 2 || status > 1 ||
+            (in.size() - pos) / sizeof(TagId) < tag_count) {
+            return false;
+        }
+        t.set_deadline(std::move(deadline));
+        t.priority = static_cast<Priority>(priority);
+        t.status = static_cast<Status>(status);
+        t.tags.resize(tag_count);
+        for (TagId& tag : t.tags) get(tag);
+        return true;
+    }
+};
+
+void put_change(std::string& out, const TaskChange& change) {
+    put(out, static_cast<uint8_t>(change.kind));
+    put(out, change.id);
+    put(out, static_cast<uint64_t>(change.slot));
+    // Пустая ручка (надгробие или нет задачи) пишется задачей с id == 0.
+    put_task(out, change.task ? *change.task : Task());
+    put(out, static_cast<uint64_t>(change.records.size()));
+    for (const TaskHandle& t : change.records) put_task(out, t ? *t : Task());
+    put(out, static_cast<uint64_t>(change.steps.size()));
+    for (const TaskChange& step : change.steps) put_change(out, step);
+}
+
+bool get_change(Reader& r, TaskChange& change) {
+    uint8_t kind = 0;
+    uint64_t slot = 0, count = 0;
+    Task task;
+    if (!r.get(kind) || kind > static_cast<uint8_t>(TaskChange::Kind::Batch) || !r.get(change.id) ||
+        !r.get(slot) || !r.get_task(task) || !r.get(count)) {
+        return false;
+    }
+    change.task = task.id == 0 ? nullptr : make_task_handle(std::move(task));
+    change.kind = static_cast<TaskChange::Kind>(kind);
+    change.slot = static_cast<size_t>(slot);
+    change.records.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        Task t;
+        if (!r.get_task(t)) return false;
+        change.records.push_back(t.id == 0 ? nullptr : make_task_handle(std::move(t)));
+    }
+    if (!r.get(count)) return false;
+    change.steps.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        change.steps.emplace_back();
+        if (!get_change(r, change.steps.back())) return false;
+    }
+    return true;
+}
+
+std::string serialize(const TaskChange& change) {
+    std::string out;
+    put_change(out, change);
+    return out;
+}
+
+bool deserialize(std::string_view in, TaskChange& change) {
+    Reader r{in};
+    return get_change(r, change) && r.pos == in.size();
+}
+}
+
+UndoHistory::UndoHistory(std::string spill_path, size_t budget) : path(std::move(spill_path)), budget(budget) {}
+
+UndoHistory::~UndoHistory() {
+    if (file.is_open()) {
+        file.close();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+}
+
+size_t UndoHistory::bytes_of(const TaskChange& change) {
+    size_t bytes = sizeof(Entry) + handle_bytes(change.task) + change.records.memory_bytes(handle_bytes) +
+                   change.steps.capacity() * sizeof(TaskChange);
+    // Сами шаги уже учтены ёмкостью steps, добавляется только то, что они держат.
+    for (const TaskChange& step : change.steps) bytes += bytes_of(step) - sizeof(Entry);
+    return bytes;
+}
+
+void UndoHistory::push(TaskChange change) {
+    Entry entry;
+    entry.bytes = bytes_of(change);
+    entry.change = std::move(change);
+    resident += entry.bytes;
+    entries.push_back(std::move(entry));
+    enforce();
+}
+
+bool UndoHistory::pop(TaskChange& out) {
+    if (entries.empty()) return false;
+    Entry& entry = entries.back();
+    if (entry.on_disk) {
+        bool ok = load(entry);
+        --spilled_count;
+        // Запись была последней в файле — её место можно занять снова.
+        file_end = entry.offset;
+        if (!ok) {
+            entries.pop_back();
+            return false;
+        }
+    } else {
+        resident -= entry.bytes;
+    }
+    out = std::move(entry.change);
+    entries.pop_back();
+    return true;
+}
+
+void UndoHistory::clear() {
+    entries.clear();
+    resident = 0;
+    spilled_count = 0;
+    file_end = 0;
+}
+
+void UndoHistory::set_budget(size_t bytes) {
+    budget = bytes;
+    if (peer) peer->budget = bytes;
+    enforce();
+}
+
+void UndoHistory::share_budget(UndoHistory& other) {
+    peer = &other;
+    other.peer = this;
+    other.budget = budget;
+    enforce();
+}
+
+void UndoHistory::enforce() {
+    while (resident + (peer ? peer->resident : 0) > budget) {
+        // Сначала выгружаем свои старые записи, затем записи парной истории.
+        if (!spill_oldest() && !(peer && peer->spill_oldest())) return;
+    }
+}
+
+bool UndoHistory::spill_oldest() {
+    // Самую новую запись не выгружаем: её почти наверняка снимут первой.
+    if (spilled_count + 1 >= entries.size()) return false;
+    Entry& oldest = entries[spilled_count];
+    if (!spill(oldest)) return false; // Файл недоступен — остаёмся в памяти.
+    resident -= oldest.bytes;
+    ++spilled_count;
+    return true;
+}
+
+bool UndoHistory::spill(Entry& entry) {
+    if (!file.is_open()) {
+        file.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        if (!file.is_open()) return false;
+    }
+    const std::string raw = serialize(entry.change);
+    const std::string packed = lz_compress(raw);
+    file.clear();
+    file.seekp(static_cast<std::streamoff>(file_end));
+    file.write(packed.data(), static_cast<std::streamsize>(packed.size()));
+    file.flush();
+    if (!file) return false;
+    entry.on_disk = true;
+    entry.offset = file_end;
+    entry.stored = packed.size();
+    entry.raw = raw.size();
+    entry.change = TaskChange();
+    file_end += packed.size();
+    return true;
+}
+
+bool UndoHistory::load(Entry& entry) {
+    std::string packed(static_cast<size_t>(entry.stored), '\0');
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(entry.offset));
+    file.read(&packed[0], static_cast<std::streamsize>(packed.size()));
+    if (!file) return false;
+    std::string raw;
+    if (!lz_decompress(packed, static_cast<size_t>(entry.raw), raw)) return false;
+    entry.on_disk = false;
+    return deserialize(raw, entry.change);
+}
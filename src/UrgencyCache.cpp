@@ -0,0 +1,91 @@
+#include "UrgencyCache.h"
+
+namespace {
+constexpr DeadlineTime kUrgentWindow = 86400;
+
+// Меньше этого числа устаревших элементов куча не пересобирается.
+constexpr size_t kMinStale = 64;
+
+/// Следующий момент, когда срочность дедлайна due изменится после now.
+DeadlineTime next_change(DeadlineTime due, DeadlineTime now) {
+    if (due == kNoDeadline || now > due) return kNoDeadline;
+    if (now < due - kUrgentWindow) return due - kUrgentWindow;
+    // Ровно в момент дедлайна задача ни срочная, ни просроченная.
+    return now < due ? due : due + 1;
+}
+}
+
+Urgency UrgencyCache::classify_at(DeadlineTime due, DeadlineTime now) {
+    if (due == kNoDeadline) return Urgency::Normal;
+    if (due < now) return Urgency::Overdue;
+    DeadlineTime diff = due - now;
+    return diff > 0 && diff <= kUrgentWindow ? Urgency::Urgent : Urgency::Normal;
+}
+
+Urgency UrgencyCache::schedule(TaskId id, DeadlineTime due) {
+    Urgency urgency = classify_at(due, now);
+    DeadlineTime at = next_change(due, now);
+    entries[id] = Entry{due, urgency, at};
+    if (at != kNoDeadline) transitions.push(Transition{at, id, due});
+    return urgency;
+}
+
+void UrgencyCache::retire(Entry& entry) {
+    if (entry.at == kNoDeadline) return;
+    entry.at = kNoDeadline;
+    ++stale;
+}
+
+void UrgencyCache::prune() {
+    if (stale < kMinStale || stale * 2 < transitions.size()) return;
+    std::vector<Transition> live;
+    live.reserve(transitions.size() - stale);
+    for (const auto& [id, entry] : entries) {
+        if (entry.at != kNoDeadline) live.push_back(Transition{entry.at, id, entry.due});
+    }
+    transitions = decltype(transitions)(std::greater<Transition>(), std::move(live));
+    stale = 0;
+}
+
+size_t UrgencyCache::advance(DeadlineTime moment) {
+    now = moment;
+    size_t changed = 0;
+    while (!transitions.empty() && transitions.top().at <= now) {
+        Transition t = transitions.top();
+        transitions.pop();
+        auto it = entries.find(t.id);
+        // Задача удалена или её дедлайн изменился — элемент устарел.
+        if (it == entries.end() || it->second.due != t.due || it->second.at != t.at) {
+            --stale;
+            continue;
+        }
+        schedule(t.id, t.due);
+        ++changed;
+    }
+    return changed;
+}
+
+Urgency UrgencyCache::classify(TaskId id, DeadlineTime due) {
+    auto it = entries.find(id);
+    if (it != entries.end()) {
+        if (it->second.due == due) return it->second.urgency;
+        retire(it->second);
+    }
+    Urgency urgency = schedule(id, due);
+    prune();
+    return urgency;
+}
+
+void UrgencyCache::forget(TaskId id) {
+    auto it = entries.find(id);
+    if (it == entries.end()) return;
+    retire(it->second);
+    entries.erase(it);
+    prune();
+}
+
+void UrgencyCache::clear() {
+    entries.clear();
+    transitions = {};
+    stale = 0;
+}
@@ -1,29 +1,454 @@
 #include "User.h"
+#include "TaskLog.h"
+#include "TaskSaxLoader.h"
+#include "TaskCodec.h"
 #include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
 
-User::User(const std::string& name) : username(name) {}
+namespace {
+// Журнал сворачивается в снимок, когда записей в нём становится больше,
+// чем задач (но не раньше этого порога), — так каждая правка в среднем O(1).
+constexpr size_t kMinCompactRecords = 1024;
 
-void User::add_task(const Task& task) {
-    tasks.push_back(task);
+// Файл выгрузки истории отмены: свой у каждого экземпляра, чтобы две
+// копии приложения с одним пользователем не писали в один файл.
+std::string undo_spill_path(const std::string& name, const char* kind) {
+    static const char kHex[] = "0123456789abcdef";
+    std::random_device random;
+    std::string suffix;
+    for (int i = 0; i < 4; ++i) {
+        uint32_t bits = random();
+        for (int j = 0; j < 8; ++j, bits >>= 4) suffix += kHex[bits & 15];
+    }
+    return (std::filesystem::temp_directory_path() / (name + "_" + kind + "_" + suffix + ".tmp")).string();
+}
+
+bool has_string(const json& j, const char* key) {
+    auto it = j.find(key);
+    return it != j.end() && it->is_string();
+}
+
+bool has_unsigned(const json& j, const char* key) {
+    auto it = j.find(key);
+    return it != j.end() && it->is_number_unsigned();
+}
+
+bool valid_task(const json& t) {
+    if (!t.is_object() || !has_unsigned(t, "id")) return false;
+    for (const char* key : {"title", "description", "priority", "status", "deadline"}) {
+        if (!has_string(t, key)) return false;
+    }
+    auto tags = t.find("tags");
+    return tags != t.end() && tags->is_array() &&
+           std::all_of(tags->begin(), tags->end(), [](const json& tag) { return tag.is_string(); });
+}
+
+// Запись журнала годится, если в ней есть всё, что читает User::apply_record.
+bool valid_record(const json& r) {
+    if (!r.is_object() || !has_unsigned(r, "seq") || !has_string(r, "op")) return false;
+    const std::string& op = r["op"].get_ref<const std::string&>();
+    if (op == "add" || op == "edit") return r.contains("task") && valid_task(r["task"]);
+    if (op == "delete") return has_unsigned(r, "id");
+    if (op == "rename_tag") return has_string(r, "from") && has_string(r, "to");
+    return false;
+}
+}
+
+User::User(const std::string& name)
+    : username(name), history(undo_spill_path(name, "undo")), redo_stack(undo_spill_path(name, "redo")) {
+    history.share_budget(redo_stack);
+}
+
+TaskId User::add_task(const Task& task) {
+    TaskChange undo;
+    TaskId id = add_one(task, undo);
+    remember(std::move(undo));
+    return id;
+}
+
+void User::delete_task(TaskId id) {
+    TaskChange undo;
+    if (delete_one(id, undo)) remember(std::move(undo));
+}
+
+void User::edit_task(TaskId id, const Task& updated_task) {
+    TaskChange undo;
+    if (edit_one(id, updated_task, undo)) remember(std::move(undo));
+}
+
+std::vector<TaskId> User::apply_batch(std::vector<TaskOp> ops) {
+    size_t adds = 0;
+    for (const TaskOp& op : ops) adds += op.kind == TaskOp::Kind::Add;
+    tasks.reserve(tasks.slot_count() + adds);
+    // Крупная пачка всё равно свернула бы журнал: пишем сразу снимок.
+    const bool as_snapshot = ops.size() > log_limit();
+    logging = !as_snapshot;
+
+    std::vector<TaskId> ids;
+    ids.reserve(ops.size());
+    TaskChange undo;
+    undo.kind = TaskChange::Kind::Batch;
+    undo.steps.reserve(ops.size());
+    for (TaskOp& op : ops) {
+        TaskChange step;
+        TaskId id = 0;
+        switch (op.kind) {
+            case TaskOp::Kind::Add:
+                id = add_one(std::move(op.task), step);
+                break;
+            case TaskOp::Kind::Edit:
+                if (edit_one(op.id, std::move(op.task), step)) id = op.id;
+                break;
+            case TaskOp::Kind::Delete:
+                if (delete_one(op.id, step)) id = op.id;
+                break;
+        }
+        if (id != 0) undo.steps.push_back(std::move(step));
+        ids.push_back(id);
+    }
+
+    logging = true;
+    if (as_snapshot) needs_snapshot = true;
+    if (!undo.steps.empty()) remember(std::move(undo));
+    return ids;
 }
 
-void User::delete_task(size_t index) {
-    if (index < tasks.size()) {
-        tasks.erase(tasks.begin() + index);
+TaskId User::add_one(Task task, TaskChange& undo) {
+    TaskId id = tasks.add(std::move(task));
+    if (logging) record({{"op", "add"}, {"task", tasks.record(tasks.find(id)).to_json(dictionary)}});
+    undo.kind = TaskChange::Kind::Remove;
+    undo.id = id;
+    return id;
+}
+
+bool User::edit_one(TaskId id, Task task, TaskChange& undo) {
+    size_t slot = tasks.find(id);
+    if (slot == IdIndex::npos) return false;
+    undo.kind = TaskChange::Kind::Assign;
+    undo.id = id;
+    undo.task = tasks.handle(slot);
+    tasks.assign(slot, std::move(task));
+    if (logging) record({{"op", "edit"}, {"task", tasks.record(slot).to_json(dictionary)}});
+    return true;
+}
+
+bool User::delete_one(TaskId id, TaskChange& undo) {
+    size_t slot = tasks.find(id);
+    if (slot == IdIndex::npos) return false;
+    undo.kind = TaskChange::Kind::Restore;
+    undo.id = id;
+    undo.task = tasks.handle(slot);
+    undo.slot = slot;
+    tasks.erase(slot);
+    if (logging) record({{"op", "delete"}, {"id", id}});
+    return true;
+}
+
+const Task* User::find_task(TaskId id) const {
+    size_t slot = tasks.find(id);
+    return slot == IdIndex::npos ? nullptr : &tasks.record(slot);
+}
+
+void User::save_to_file() {
+    // Запись могла оборваться посередине — следующее сохранение перепишет снимок.
+    if (!take_changes().write()) needs_snapshot = true;
+}
+
+PersistBatch User::take_changes() {
+    PersistBatch batch;
+    batch.log_path = log_path();
+    batch.snapshot_path = snapshot_path();
+
+    if (needs_snapshot || logged_records + pending_count > log_limit()) {
+        batch.snapshot = true;
+        // Снимок за O(1): фоновый поток читает его, пока интерфейс меняет свою копию.
+        batch.tasks = tasks.records();
+        batch.task_count = tasks.size();
+        batch.tags = dictionary;
+        batch.seq = seq;
+        logged_records = 0;
+        needs_snapshot = false;
+    } else {
+        batch.records = std::move(pending);
+        batch.record_count = pending_count;
+        logged_records += pending_count;
     }
+    pending.clear();
+    pending_count = 0;
+    return batch;
 }
 
-std::vector<Task> User::search_tasks(const std::string& keyword) const {
-    std::vector<Task> results;
-    for (const auto& task : tasks) {
+void User::load_from_file() {
+    tasks.clear();
+    dictionary.clear();
+    history.clear();
+    redo_stack.clear();
+    pending.clear();
+    pending_count = 0;
+    needs_snapshot = false;
+    seq = 0;
+
+    auto snapshot = std::make_shared<TaskSnapshot>();
+    std::error_code ec;
+    if (snapshot->open(snapshot_path())) {
+        // Снимок читается на месте: задачи собираются из отображения по мере обращения.
+        std::vector<TagId> tag_ids = snapshot->intern_names(dictionary);
+        seq = snapshot->seq();
+        // Новые идентификаторы попадут на диск со следующим снимком.
+        needs_snapshot = tasks.restore(std::move(snapshot), std::move(tag_ids));
+    } else if (std::filesystem::exists(snapshot_path(), ec) || ec) {
+        // Журнал — изменения поверх этого снимка; старый файл импорта с ним не сочетается.
+        throw std::runtime_error(snapshot_path() + ": invalid or unreadable snapshot");
+    } else {
+        std::vector<Task> loaded;
+        for (const TaskCodec* codec : TaskCodec::all()) {
+            const std::string path = username + "_tasks" + codec->extension();
+            if (!std::ifstream(path).is_open()) continue;
+            std::string error;
+            if (!read_tasks(path, loaded, dictionary, seq, error)) {
+                throw std::runtime_error(path + ": " + error);
+            }
+            break;
+        }
+        needs_snapshot = tasks.restore(std::move(loaded), true);
+    }
+
+    const uint64_t base = seq;
+    TaskLog log(log_path());
+    logged_records = log.replay([&](const json& r) {
+        if (!valid_record(r)) return false;
+        uint64_t s = r["seq"].get<uint64_t>();
+        if (s <= base) return true; // Уже учтено в снимке.
+        apply_record(r);
+        seq = s;
+        return true;
+    });
+}
+
+bool User::export_tasks(const std::string& path) const {
+    const TaskCodec* codec = TaskCodec::for_path(path);
+    if (!codec) return false;
+    std::ofstream file(path, std::ios::binary);
+    codec->encode(tasks.tasks(), dictionary, file);
+    return static_cast<bool>(file);
+}
+
+bool User::import_tasks(const std::string& path) {
+    std::vector<Task> imported;
+    uint64_t ignored = 0;
+    std::string error;
+    if (!read_tasks(path, imported, dictionary, ignored, error)) return false;
+    TaskChange undo;
+    undo.kind = TaskChange::Kind::Reset;
+    undo.records = tasks.records();
+    tasks.restore(std::move(imported), true);
+    remember(std::move(undo));
+    // Замена всего списка не выражается записями журнала.
+    needs_snapshot = true;
+    return true;
+}
+
+bool User::read_tasks(const std::string& path, std::vector<Task>& out, TagDictionary& dictionary,
+                      uint64_t& file_seq, std::string& error) {
+    const TaskCodec* codec = TaskCodec::for_path(path);
+    if (!codec) {
+        error = "unsupported file format";
+        return false;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "cannot open file";
+        return false;
+    }
+    TaskSaxLoader loader(out, dictionary);
+    if (!codec->decode(file, loader)) {
+        error = loader.error();
+        return false;
+    }
+    file_seq = loader.seq();
+    return true;
+}
+
+size_t User::log_limit() const {
+    return std::max(kMinCompactRecords, tasks.size());
+}
+
+void User::compact() {
+    needs_snapshot = true;
+    save_to_file();
+}
+
+void User::undo() {
+    TaskChange change;
+    if (!history.pop(change)) return;
+    revert(change);
+    redo_stack.push(std::move(change));
+}
+
+void User::redo() {
+    TaskChange change;
+    if (!redo_stack.pop(change)) return;
+    revert(change);
+    history.push(std::move(change));
+}
+
+void User::remember(TaskChange change) {
+    history.push(std::move(change));
+    redo_stack.clear();
+}
+
+void User::revert(TaskChange& change) {
+    switch (change.kind) {
+        case TaskChange::Kind::Remove: {
+            size_t slot = tasks.find(change.id);
+            if (slot == IdIndex::npos) return;
+            change.kind = TaskChange::Kind::Restore;
+            change.task = tasks.handle(slot);
+            change.slot = slot;
+            tasks.erase(slot);
+            if (logging) record({{"op", "delete"}, {"id", change.id}});
+            break;
+        }
+        case TaskChange::Kind::Restore:
+            tasks.revive(change.slot, std::move(change.task));
+            if (logging) record({{"op", "add"}, {"task", tasks.record(tasks.find(change.id)).to_json(dictionary)}});
+            change.kind = TaskChange::Kind::Remove;
+            change.task = nullptr;
+            break;
+        case TaskChange::Kind::Assign: {
+            size_t slot = tasks.find(change.id);
+            if (slot == IdIndex::npos) return;
+            TaskHandle current = tasks.handle(slot);
+            tasks.assign(slot, std::move(change.task));
+            if (logging) record({{"op", "edit"}, {"task", tasks.record(slot).to_json(dictionary)}});
+            change.task = std::move(current);
+            break;
+        }
+        case TaskChange::Kind::Reset: {
+            TaskTable current = tasks.records();
+            tasks.restore(change.records);
+            change.records = std::move(current);
+            // Замена всего списка не выражается записями журнала.
+            needs_snapshot = true;
+            break;
+        }
+        case TaskChange::Kind::Batch: {
+            const bool as_snapshot = change.steps.size() > log_limit();
+            logging = !as_snapshot;
+            for (auto it = change.steps.rbegin(); it != change.steps.rend(); ++it) revert(*it);
+            // Обратные операции выполняются в исходном порядке изменений.
+            std::reverse(change.steps.begin(), change.steps.end());
+            logging = true;
+            if (as_snapshot) needs_snapshot = true;
+            break;
+        }
+    }
+}
+
+bool User::rename_tag(const std::string& from, const std::string& to) {
+    if (!dictionary.rename(from, to)) return false;
+    record({{"op", "rename_tag"}, {"from", from}, {"to", to}});
+    return true;
+}
+
+std::vector<TaskHandle> User::search_tasks(const std::string& keyword) const {
+    std::vector<TaskHandle> results;
+    tasks.live_slots().for_each([&](uint32_t slot) {
+        const Task& task = tasks.record(slot);
         if (task.title.find(keyword) != std::string::npos ||
             task.description.find(keyword) != std::string::npos) {
-            results.push_back(task);
+            results.push_back(tasks.handle(slot));
         }
-    }
+    });
     return results;
 }
 
-const std::vector<Task>& User::get_tasks() const {
-    return tasks;
+std::vector<TaskHandle> User::filter_by_tag(const std::string& tag) const {
+    TagId id = dictionary.find(tag);
+    if (id == TagDictionary::npos) return {};
+    return TaskView(tasks, &tasks.tag_slots(id)).handles();
+}
+
+TaskView User::filter_by_tags(const TagQuery& query) const {
+    if (query.empty()) return TaskView(tasks, &tasks.live_slots());
+    return TaskView(tasks, query.evaluate(tasks, dictionary));
+}
+
+DeadlineView User::tasks_by_deadline(bool descending) const {
+    const auto& order = tasks.deadline_order();
+    return DeadlineView(tasks, order.begin(), order.end(), descending);
+}
+
+std::vector<const Task*> User::next_up(size_t k) const {
+    std::vector<const Task*> result;
+    const auto& order = tasks.next_order();
+    result.reserve(std::min(k, order.size()));
+    for (auto it = order.begin(); it != order.end() && result.size() < k; ++it) {
+        result.push_back(&tasks.record(tasks.find(std::get<3>(*it))));
+    }
+    return result;
+}
+
+DeadlineView User::tasks_due_between(DeadlineTime from, DeadlineTime to, bool descending) const {
+    const auto& order = tasks.deadline_order();
+    // Идентификатор 0 не назначается задачам, поэтому (t, 0) — начало всех ключей с дедлайном t.
+    auto first = order.lower_bound(TaskStore::DeadlineKey(from, 0));
+    auto last = to <= from ? first : order.lower_bound(TaskStore::DeadlineKey(to, 0));
+    return DeadlineView(tasks, first, last, descending);
+}
+
+std::map<Priority, int> User::get_priority_stats() const {
+    std::map<Priority, int> stats;
+    for (Priority p : {Priority::Low, Priority::Medium, Priority::High}) {
+        if (int n = tasks.priority_count(p)) stats[p] = n;
+    }
+    return stats;
+}
+
+const std::map<std::string, int>& User::get_deadline_calendar() const {
+    return tasks.deadline_counts();
+}
+
+TaskView User::filter_by_status(Status status) const {
+    return TaskView(tasks, &tasks.status_slots(status));
+}
+
+TaskView User::filter_by_priority(Priority priority) const {
+    return TaskView(tasks, &tasks.priority_slots(priority));
+}
+
+TaskView User::filter_by_status_and_priority(Status status, Priority priority) const {
+    return TaskView(tasks, tasks.status_slots(status) & tasks.priority_slots(priority));
+}
+
+TaskRange User::get_tasks() const {
+    return tasks.tasks();
+}
+
+void User::record(json record) {
+    record["seq"] = ++seq;
+    pending += record.dump();
+    pending += '\n';
+    ++pending_count;
+}
+
+void User::apply_record(const json& record) {
+    const std::string op = record.at("op").get<std::string>();
+    if (op == "add") {
+        tasks.insert(Task::from_json(record.at("task"), dictionary));
+        return;
+    }
+    if (op == "edit") {
+        Task t = Task::from_json(record.at("task"), dictionary);
+        size_t slot = tasks.find(t.id);
+        if (slot != IdIndex::npos) tasks.assign(slot, std::move(t));
+    } else if (op == "delete") {
+        size_t slot = tasks.find(record.at("id").get<TaskId>());
+        if (slot != IdIndex::npos) tasks.erase(slot);
+    } else if (op == "rename_tag") {
+        dictionary.rename(record.at("from").get<std::string>(), record.at("to").get<std::string>());
+    }
 }
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "../include/Deadline.h"
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+/// Прежний разбор через std::get_time и std::mktime — эталон для сравнения.
+DeadlineTime reference_parse(const std::string& text) {
+    std::tm tm = {};
+    std::istringstream ss(text);
+    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
+    if (ss.fail()) return kNoDeadline;
+    return static_cast<DeadlineTime>(std::mktime(&tm));
+}
+
+std::string format(int year, int month, int day, int hour, int minute) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d", year, month, day, hour, minute);
+    return buf;
+}
+}
+
+TEST(DeadlineTests, MatchesGetTimeAndMktime) {
+    std::mt19937 rng(7);
+    const int month_days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    for (int i = 0; i < 20000; ++i) {
+        int year = 1971 + static_cast<int>(rng() % 129);
+        int month = 1 + static_cast<int>(rng() % 12);
+        bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+        int days = month_days[month - 1] + (month == 2 && leap);
+        std::string text = format(year, month, 1 + static_cast<int>(rng() % days),
+                                  static_cast<int>(rng() % 24), static_cast<int>(rng() % 60));
+        ASSERT_EQ(parse_deadline(text), reference_parse(text)) << text;
+    }
+    EXPECT_EQ(parse_deadline("2024-02-29 23:59"), reference_parse("2024-02-29 23:59"));
+    EXPECT_EQ(parse_deadline("2000-02-29 00:00"), reference_parse("2000-02-29 00:00"));
+}
+
+TEST(DeadlineTests, RejectsMalformedStrings) {
+    for (const char* text : {"", "2030-01-01", "2030-01-01 10:00 ", "2030-1-5 9:30", "2030/01/01 10:00",
+                             "2030-01-01T10:00", "abcd-ef-gh ij:kl", "2030-00-10 10:00", "2030-13-01 10:00",
+                             "2030-01-00 10:00", "2030-04-31 10:00", "2023-02-29 10:00", "1900-02-29 10:00",
+                             "2030-01-01 24:00", "2030-01-01 10:60"}) {
+        EXPECT_EQ(parse_deadline(text), kNoDeadline) << text;
+    }
+}
+
+TEST(DeadlineTests, MakeAndSplitAreInverse) {
+    EXPECT_EQ(make_deadline(2030, 1, 15, 12, 30), parse_deadline("2030-02-15 12:30"));
+    EXPECT_EQ(make_deadline(2030, 12, 1), parse_deadline("2031-01-01 00:00"));
+    EXPECT_EQ(make_deadline(2030, -1, 1), parse_deadline("2029-12-01 00:00"));
+    EXPECT_EQ(make_deadline(2030, 1, 29), parse_deadline("2030-03-01 00:00"));
+
+    DeadlineDate date = split_deadline(parse_deadline("2028-02-29 07:05"));
+    EXPECT_EQ(date.year, 2028);
+    EXPECT_EQ(date.month, 1);
+    EXPECT_EQ(date.day, 29);
+    EXPECT_EQ(date.hour, 7);
+    EXPECT_EQ(date.minute, 5);
+    date = split_deadline(parse_deadline("2030-12-31 23:59"));
+    EXPECT_EQ(date.year, 2030);
+    EXPECT_EQ(date.month, 11);
+    EXPECT_EQ(date.day, 31);
+}
+
+#ifndef _WIN32
+TEST(DeadlineTests, SplitUsesTheOffsetOfTheInstantWhenTheZoneChanges) {
+    // 26.10.2014 в 02:00 Москва перешла с UTC+4 на UTC+3 (стандартное время).
+    const char* old_tz = std::getenv("TZ");
+    const std::string saved = old_tz ? old_tz : "";
+    setenv("TZ", "Europe/Moscow", 1);
+    tzset();
+    // Смещения кэшируются в потоке: свой поток не оставляет московских смещений другим тестам.
+    std::thread([] {
+        for (const char* text : {"2014-10-26 00:30", "2014-10-26 03:00", "2014-10-26 23:59",
+                                 "2014-11-01 02:00", "2014-10-01 03:30", "2030-03-01 01:00"}) {
+            DeadlineTime time = parse_deadline(text);
+            ASSERT_EQ(time, reference_parse(text)) << text;
+            DeadlineDate date = split_deadline(time);
+            EXPECT_EQ(format(date.year, date.month + 1, date.day, date.hour, date.minute), text);
+        }
+    }).join();
+    if (old_tz) setenv("TZ", saved.c_str(), 1);
+    else unsetenv("TZ");
+    tzset();
+}
+#endif
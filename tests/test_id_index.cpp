@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "../include/IdIndex.h"
+#include <random>
+#include <unordered_map>
+
+TEST(IdIndexTests, InsertFindErase) {
+    IdIndex index;
+    EXPECT_EQ(index.find(1), IdIndex::npos);
+    index.insert(1, 10);
+    index.insert(2, 20);
+    index.insert(1, 11);
+    EXPECT_EQ(index.size(), 2);
+    EXPECT_EQ(index.find(1), 11u);
+    EXPECT_TRUE(index.erase(1));
+    EXPECT_FALSE(index.erase(1));
+    EXPECT_EQ(index.find(1), IdIndex::npos);
+    EXPECT_EQ(index.find(2), 20u);
+}
+
+TEST(IdIndexTests, MatchesUnorderedMapUnderRandomOperations) {
+    IdIndex index;
+    std::unordered_map<uint64_t, size_t> reference;
+    std::mt19937_64 rng(42);
+    for (int step = 0; step < 200000; ++step) {
+        uint64_t id = rng() % 5000 + 1;
+        switch (rng() % 3) {
+            case 0:
+                index.insert(id, step);
+                reference[id] = step;
+                break;
+            case 1:
+                EXPECT_EQ(index.erase(id), reference.erase(id) == 1);
+                break;
+            default: {
+                auto it = reference.find(id);
+                EXPECT_EQ(index.find(id), it == reference.end() ? IdIndex::npos : it->second);
+            }
+        }
+    }
+    EXPECT_EQ(index.size(), reference.size());
+    for (const auto& [id, slot] : reference) EXPECT_EQ(index.find(id), slot);
+}
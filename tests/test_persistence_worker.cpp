@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "../include/PersistenceWorker.h"
+#include "../include/User.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+void remove_user_files(const std::string& name) {
+    std::remove((name + "_tasks.bin").c_str());
+    std::remove((name + "_tasks.log").c_str());
+}
+}
+
+TEST(PersistenceWorkerTests, CoalescesBurstIntoOneWrite) {
+    const std::string name = "worker_test_user";
+    remove_user_files(name);
+    User user(name);
+    {
+        PersistenceWorker worker(std::chrono::milliseconds(50));
+        for (int i = 0; i < 20; ++i) {
+            user.add_task(Task{"T" + std::to_string(i), "", Priority::Low, Status::Active, "", {}});
+            worker.submit(user.take_changes());
+        }
+        worker.flush();
+        auto results = worker.poll();
+        ASSERT_EQ(results.size(), 1);
+        EXPECT_TRUE(results[0].ok);
+    }
+
+    User reloaded(name);
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.get_tasks().size(), 20);
+    EXPECT_EQ(reloaded.get_tasks().back().title, "T19");
+    remove_user_files(name);
+}
+
+TEST(PersistenceWorkerTests, SnapshotSupersedesQueuedRecordsAndDestructorFlushes) {
+    const std::string name = "worker_snapshot_user";
+    remove_user_files(name);
+    User user(name);
+    {
+        PersistenceWorker worker(std::chrono::seconds(10), std::chrono::seconds(10));
+        user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {}});
+        user.add_task(Task{"B", "", Priority::Low, Status::Active, "", {}});
+        worker.submit(user.take_changes());
+        user.undo();
+        user.request_snapshot();
+        worker.submit(user.take_changes());
+        user.add_task(Task{"C", "", Priority::Low, Status::Active, "", {}});
+        worker.submit(user.take_changes());
+    }
+
+    // Снимок поглотил записи A и B из очереди; после него в журнале только C.
+    EXPECT_TRUE(std::ifstream(name + "_tasks.bin").good());
+    User reloaded(name);
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.get_tasks().size(), 2);
+    EXPECT_EQ(reloaded.get_tasks().begin()->title, "A");
+    EXPECT_EQ(reloaded.get_tasks().back().title, "C");
+    remove_user_files(name);
+}
+
+TEST(PersistenceWorkerTests, ReportsWriteErrors) {
+    User user("missing_dir/worker_user");
+    PersistenceWorker worker(std::chrono::milliseconds(1));
+    user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {}});
+    worker.submit(user.take_changes());
+    worker.flush();
+    auto results = worker.poll();
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_FALSE(results[0].ok);
+    EXPECT_FALSE(results[0].message.empty());
+}
+
+TEST(PersistenceWorkerTests, FailedWriteStopsAppendsUntilASnapshotSucceeds) {
+    const std::string dir = "worker_broken_dir";
+    std::filesystem::remove_all(dir);
+    User user(dir + "/worker_user");
+    PersistenceWorker worker(std::chrono::milliseconds(1));
+    user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {}});
+    worker.submit(user.take_changes());
+    worker.flush();
+    ASSERT_FALSE(worker.poll().at(0).ok);
+
+    // Каталог появился, но журнал после сбоя дописывать нельзя — только снимок.
+    std::filesystem::create_directory(dir);
+    user.add_task(Task{"B", "", Priority::Low, Status::Active, "", {}});
+    worker.submit(user.take_changes());
+    worker.flush();
+    EXPECT_FALSE(worker.poll().at(0).ok);
+    EXPECT_FALSE(std::filesystem::exists(dir + "/worker_user_tasks.log"));
+
+    user.request_snapshot();
+    worker.submit(user.take_changes());
+    worker.flush();
+    EXPECT_TRUE(worker.poll().at(0).ok);
+    user.add_task(Task{"C", "", Priority::Low, Status::Active, "", {}});
+    worker.submit(user.take_changes());
+    worker.flush();
+    EXPECT_TRUE(worker.poll().at(0).ok);
+
+    User reloaded(dir + "/worker_user");
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.get_tasks().size(), 3);
+    EXPECT_EQ(reloaded.get_tasks().back().title, "C");
+    std::filesystem::remove_all(dir);
+}
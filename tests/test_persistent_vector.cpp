@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "../include/PersistentVector.h"
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(PersistentVectorTests, MatchesStdVectorAcrossLevels) {
+    PersistentVector<int> v;
+    std::vector<int> reference;
+    for (int i = 0; i < 40000; ++i) {
+        v.push_back(i);
+        reference.push_back(i);
+    }
+    std::mt19937 rng(5);
+    for (int step = 0; step < 10000; ++step) {
+        size_t i = rng() % reference.size();
+        v.set(i, step);
+        reference[i] = step;
+    }
+    ASSERT_EQ(v.size(), reference.size());
+    EXPECT_EQ(std::vector<int>(v.begin(), v.end()), reference);
+    for (size_t i = 0; i < reference.size(); i += 97) EXPECT_EQ(v[i], reference[i]);
+}
+
+TEST(PersistentVectorTests, AssignBuildsTheSameTreeAsPushBack) {
+    // Границы уровней: ровно лист, лист и ещё один, ровно два уровня, три уровня.
+    for (size_t n : {size_t{0}, size_t{1}, size_t{32}, size_t{33}, size_t{1024}, size_t{1025}, size_t{40000}}) {
+        PersistentVector<int> v;
+        v.assign(n, 7);
+        std::vector<int> reference(n, 7);
+        for (int i = 0; i < 100; ++i) {
+            v.push_back(i);
+            reference.push_back(i);
+        }
+        v.set(0, -1);
+        reference[0] = -1;
+        ASSERT_EQ(v.size(), reference.size());
+        EXPECT_EQ(std::vector<int>(v.begin(), v.end()), reference);
+    }
+}
+
+TEST(PersistentVectorTests, SnapshotsAreUnaffectedByLaterChanges) {
+    PersistentVector<std::string> v;
+    for (int i = 0; i < 3000; ++i) v.push_back("v" + std::to_string(i));
+    PersistentVector<std::string> snapshot = v;
+
+    v.set(0, "changed");
+    v.set(2999, "changed too");
+    v.push_back("appended");
+    EXPECT_EQ(snapshot.size(), 3000u);
+    EXPECT_EQ(snapshot[0], "v0");
+    EXPECT_EQ(snapshot[2999], "v2999");
+    EXPECT_EQ(v[0], "changed");
+    EXPECT_EQ(v[3000], "appended");
+
+    // take() копирует из узлов, которые ещё видит снимок.
+    std::string taken = v.take(1);
+    EXPECT_EQ(taken, "v1");
+    EXPECT_EQ(snapshot[1], "v1");
+}
+
+TEST(PersistentVectorTests, SnapshotCanBeReadFromAnotherThread) {
+    PersistentVector<int> v;
+    for (int i = 0; i < 100000; ++i) v.push_back(i);
+    PersistentVector<int> snapshot = v;
+
+    std::atomic<bool> ok{true};
+    std::thread reader([&] {
+        for (int round = 0; round < 20; ++round) {
+            int expected = 0;
+            for (int x : snapshot) ok = ok && x == expected++;
+        }
+    });
+    for (int i = 0; i < 100000; ++i) v.set(static_cast<size_t>(i), -i);
+    reader.join();
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(v[99999], -99999);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "../include/ReminderWheel.h"
+#include "../include/ReminderTimer.h"
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+
+namespace {
+using Key = std::tuple<TaskId, ReminderKind, DeadlineTime>;
+}
+
+TEST(ReminderWheelTests, FiresDueSoonThenOverdue) {
+    const DeadlineTime start = 1700000000 / 60 * 60;
+    ReminderWheel wheel(start);
+    const DeadlineTime due = start + 3 * 86400;
+    wheel.schedule(1, due);
+    wheel.schedule(2, start + 3600); // «остались сутки» уже прошло
+    wheel.schedule(3, kNoDeadline);
+    EXPECT_EQ(wheel.pending(), 3u);
+
+    EXPECT_TRUE(wheel.advance(start + 3599).empty());
+    auto fired = wheel.advance(start + 3600);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].id, 2u);
+    EXPECT_EQ(fired[0].kind, ReminderKind::Overdue);
+
+    EXPECT_TRUE(wheel.advance(due - 86400 - 1).empty());
+    fired = wheel.advance(due - 86400);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0].kind, ReminderKind::DueSoon);
+
+    wheel.schedule(1, due + 2 * 86400); // перенос дедлайна отменяет прежние напоминания
+    EXPECT_TRUE(wheel.advance(due + 60).empty());
+    wheel.cancel(1);
+    EXPECT_EQ(wheel.pending(), 0u);
+    EXPECT_TRUE(wheel.advance(due + 3 * 86400).empty());
+}
+
+TEST(ReminderWheelTests, MatchesBruteForceAcrossAllLevels) {
+    std::mt19937_64 rng(11);
+    const DeadlineTime start = 1700000000 / 60 * 60;
+    ReminderWheel wheel(start);
+    std::map<TaskId, DeadlineTime> dues;
+    std::set<Key> expected_pending;
+
+    auto add_expected = [&](TaskId id, DeadlineTime due, DeadlineTime now) {
+        for (auto [kind, at] : {std::pair{ReminderKind::DueSoon, due - 86400}, std::pair{ReminderKind::Overdue, due}}) {
+            if (at > now) expected_pending.insert(Key{id, kind, at});
+        }
+    };
+    auto drop_expected = [&](TaskId id) {
+        for (auto it = expected_pending.begin(); it != expected_pending.end();) {
+            it = std::get<0>(*it) == id ? expected_pending.erase(it) : std::next(it);
+        }
+    };
+
+    DeadlineTime now = start;
+    for (int step = 0; step < 3000; ++step) {
+        TaskId id = rng() % 200 + 1;
+        if (rng() % 5 == 0) {
+            wheel.cancel(id);
+            drop_expected(id);
+        } else {
+            // Дедлайны от минут до двух лет вперёд, на границах минут.
+            DeadlineTime due = now / 60 * 60 + static_cast<DeadlineTime>(rng() % (2 * 366 * 1440)) * 60;
+            wheel.schedule(id, due);
+            drop_expected(id);
+            add_expected(id, due, now);
+        }
+        now += static_cast<DeadlineTime>(rng() % 6) * static_cast<DeadlineTime>(rng() % 2 ? 60 : 86400);
+
+        std::set<Key> got;
+        for (const Reminder& r : wheel.advance(now)) {
+            EXPECT_LE(r.at, now);
+            got.insert(Key{r.id, r.kind, r.at});
+        }
+        std::set<Key> want;
+        for (auto it = expected_pending.begin(); it != expected_pending.end();) {
+            if (std::get<2>(*it) <= now) {
+                want.insert(*it);
+                it = expected_pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        ASSERT_EQ(got, want) << "step " << step;
+        ASSERT_EQ(wheel.pending(), expected_pending.size());
+    }
+}
+
+TEST(ReminderWheelTests, TimerExpiresAtAbsoluteMoment) {
+    ReminderTimer timer;
+    EXPECT_FALSE(timer.expired(0));
+    timer.arm(1);
+    EXPECT_TRUE(timer.expired(2));
+    EXPECT_FALSE(timer.expired(3));
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "../include/RoaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+
+namespace {
+std::vector<uint32_t> values(const std::set<uint32_t>& s) {
+    return std::vector<uint32_t>(s.begin(), s.end());
+}
+
+RoaringBitmap random_bitmap(std::mt19937& rng, std::set<uint32_t>& reference, size_t count, uint32_t range) {
+    RoaringBitmap bitmap;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t v = rng() % range;
+        EXPECT_EQ(bitmap.add(v), reference.insert(v).second);
+    }
+    return bitmap;
+}
+}
+
+TEST(RoaringBitmapTests, AddRemoveContains) {
+    RoaringBitmap bitmap;
+    EXPECT_TRUE(bitmap.add(5));
+    EXPECT_FALSE(bitmap.add(5));
+    EXPECT_TRUE(bitmap.add(70000));
+    EXPECT_TRUE(bitmap.contains(5));
+    EXPECT_FALSE(bitmap.contains(6));
+    EXPECT_EQ(bitmap.cardinality(), 2u);
+    EXPECT_TRUE(bitmap.remove(5));
+    EXPECT_FALSE(bitmap.remove(5));
+    EXPECT_TRUE(bitmap.remove(70000));
+    EXPECT_TRUE(bitmap.empty());
+}
+
+TEST(RoaringBitmapTests, DenseBlocksConvertBothWays) {
+    RoaringBitmap bitmap;
+    for (uint32_t v = 0; v < 10000; ++v) bitmap.add(v * 2);
+    EXPECT_EQ(bitmap.cardinality(), 10000u);
+    EXPECT_TRUE(bitmap.contains(19998));
+    EXPECT_FALSE(bitmap.contains(19999));
+    for (uint32_t v = 0; v < 9000; ++v) bitmap.remove(v * 2);
+    EXPECT_EQ(bitmap.cardinality(), 1000u);
+    std::vector<uint32_t> expected;
+    for (uint32_t v = 9000; v < 10000; ++v) expected.push_back(v * 2);
+    EXPECT_EQ(bitmap.to_vector(), expected);
+    EXPECT_EQ(std::vector<uint32_t>(bitmap.begin(), bitmap.end()), expected);
+}
+
+TEST(RoaringBitmapTests, AppendMatchesAdd) {
+    std::mt19937 rng(3);
+    RoaringBitmap appended, added;
+    uint32_t v = 0;
+    for (int i = 0; i < 20000; ++i) {
+        // Шаги разной длины дают и разреженные, и плотные блоки; изредка число повторяется или идёт назад.
+        v += rng() % 8;
+        uint32_t x = i % 1000 == 999 ? v / 2 : v;
+        appended.append(x);
+        added.add(x);
+    }
+    EXPECT_EQ(appended, added);
+    EXPECT_EQ(appended.to_vector(), added.to_vector());
+}
+
+TEST(RoaringBitmapTests, FromWordsMatchesAdd) {
+    std::mt19937 rng(11);
+    // Первый блок плотный, второй разреженный, третий пустой, четвёртый неполный.
+    std::vector<uint64_t> words(3 * 1024 + 10, 0);
+    RoaringBitmap added;
+    for (uint32_t v = 0; v < words.size() * 64; ++v) {
+        const bool dense = v < 65536;
+        const bool sparse = v >= 65536 && v < 2 * 65536 && rng() % 100 == 0;
+        const bool tail = v >= 3 * 65536 && rng() % 2 == 0;
+        if (dense || sparse || tail) {
+            words[v / 64] |= uint64_t{1} << (v % 64);
+            added.add(v);
+        }
+    }
+    EXPECT_EQ(RoaringBitmap::from_words(words), added);
+    EXPECT_TRUE(RoaringBitmap::from_words({}).empty());
+}
+
+TEST(RoaringBitmapTests, SetOperationsMatchStdSet) {
+    std::mt19937 rng(7);
+    // Разная плотность, чтобы встретились все сочетания массивов и битовых карт.
+    const size_t counts[] = {100, 3000, 20000, 60000};
+    for (size_t ca : counts) {
+        for (size_t cb : counts) {
+            std::set<uint32_t> a, b;
+            RoaringBitmap ra = random_bitmap(rng, a, ca, 200000);
+            RoaringBitmap rb = random_bitmap(rng, b, cb, 200000);
+
+            std::set<uint32_t> both, either, only;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(both, both.end()));
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(either, either.end()));
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(only, only.end()));
+
+            RoaringBitmap rboth = ra & rb;
+            RoaringBitmap reither = ra | rb;
+            RoaringBitmap ronly = ra - rb;
+            EXPECT_EQ(rboth.to_vector(), values(both));
+            EXPECT_EQ(reither.to_vector(), values(either));
+            EXPECT_EQ(ronly.to_vector(), values(only));
+            EXPECT_EQ(rboth.cardinality(), both.size());
+            EXPECT_EQ(reither.cardinality(), either.size());
+            EXPECT_EQ(ronly.cardinality(), only.size());
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "../include/TaskJsonWriter.h"
+#include "../include/TaskStore.h"
+#include <sstream>
+
+namespace {
+TagDictionary dictionary;
+
+std::string dom_dump(const std::vector<Task>& tasks) {
+    json items = json::array();
+    for (const auto& t : tasks) items.push_back(t.to_json(dictionary));
+    return items.dump();
+}
+
+std::string writer_dump(const std::vector<Task>& tasks, size_t buffer_size = 1 << 20) {
+    std::ostringstream out;
+    {
+        TaskJsonWriter writer(out, dictionary, buffer_size);
+        writer.write_array(tasks);
+    }
+    return out.str();
+}
+}
+
+TEST(TaskJsonWriterTests, MatchesNlohmannDumpByteForByte) {
+    std::string control;
+    for (char c = 1; c < 0x20; ++c) control += c;
+    std::vector<Task> tasks = {
+        Task{"Plain", "", Priority::Low, Status::Active, "2030-01-01 12:00", {}},
+        Task{"Quote \" backslash \\ slash /", control + "\x7f", Priority::Medium, Status::Done, "",
+             {dictionary.intern("a"), dictionary.intern("b c")}},
+        Task{"Юникод ✓", "tab\there\nnewline", Priority::High, Status::Active, "bad date", {dictionary.intern("тег")}},
+    };
+    EXPECT_EQ(writer_dump(tasks), dom_dump(tasks));
+    EXPECT_EQ(writer_dump({}), dom_dump({}));
+}
+
+TEST(TaskJsonWriterTests, SmallBufferProducesSameOutput) {
+    std::vector<Task> tasks;
+    for (int i = 0; i < 200; ++i) {
+        tasks.push_back(Task{"Task " + std::to_string(i), std::string(i, 'x'), Priority::Low, Status::Active,
+                             "2030-01-01 12:00", {dictionary.intern("t" + std::to_string(i))}});
+    }
+    EXPECT_EQ(writer_dump(tasks, 64), dom_dump(tasks));
+}
+
+TEST(TaskJsonWriterTests, StoreRangeSkipsTombstonesWithoutCopying) {
+    TaskStore store;
+    std::vector<TaskId> ids;
+    for (int i = 0; i < 10; ++i) {
+        ids.push_back(store.add(Task{"Task " + std::to_string(i), "", Priority::Low, Status::Active, "", {}}));
+    }
+    store.erase(store.find(ids[3]));
+    store.erase(store.find(ids[7]));
+    TaskRange range = store.tasks();
+    std::vector<Task> expected(range.begin(), range.end());
+
+    std::ostringstream out;
+    {
+        TaskJsonWriter writer(out, dictionary);
+        writer.write_array(range);
+    }
+    EXPECT_EQ(out.str(), dom_dump(expected));
+}
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include "../include/TaskStore.h"
+#include "../include/TagQuery.h"
+#include "../include/TaskView.h"
+#include "../include/TaskSnapshot.h"
+#include <cstdio>
+#include <memory>
+
+namespace {
+Task make(const std::string& title, Priority p, Status s, const std::string& deadline = "2030-01-15 12:00") {
+    return Task(title, "", p, s, deadline, {});
+}
+
+/// Индексы и записи двух хранилищ совпадают позиция в позицию.
+void expect_same(const TaskStore& a, const TaskStore& b, const TagDictionary& dictionary) {
+    ASSERT_EQ(a.slot_count(), b.slot_count());
+    EXPECT_EQ(a.size(), b.size());
+    for (size_t slot = 0; slot < a.slot_count(); ++slot) {
+        EXPECT_EQ(a.id(slot), b.id(slot));
+        EXPECT_EQ(a.deadline(slot), b.deadline(slot));
+        EXPECT_EQ(a.find(a.id(slot)), b.find(b.id(slot)));
+    }
+    EXPECT_EQ(a.live_slots(), b.live_slots());
+    for (Status s : {Status::Active, Status::Done}) EXPECT_EQ(a.status_slots(s), b.status_slots(s));
+    for (Priority p : {Priority::Low, Priority::Medium, Priority::High}) {
+        EXPECT_EQ(a.priority_slots(p), b.priority_slots(p));
+        EXPECT_EQ(a.priority_count(p), b.priority_count(p));
+    }
+    for (TagId tag = 0; tag < dictionary.size(); ++tag) EXPECT_EQ(a.tag_slots(tag), b.tag_slots(tag));
+    EXPECT_EQ(a.deadline_order(), b.deadline_order());
+    EXPECT_EQ(a.next_order(), b.next_order());
+    EXPECT_EQ(a.deadline_counts(), b.deadline_counts());
+}
+}
+
+TEST(TaskStoreTests, HotColumnsFollowRecords) {
+    TaskStore store;
+    TaskId a = store.add(make("A", Priority::High, Status::Active));
+    TaskId b = store.add(make("B", Priority::Low, Status::Done, "not a date"));
+    size_t sa = store.find(a);
+    size_t sb = store.find(b);
+    EXPECT_EQ(store.priority(sa), Priority::High);
+    EXPECT_EQ(store.status(sb), Status::Done);
+    EXPECT_NE(store.deadline(sa), kNoDeadline);
+    EXPECT_EQ(store.deadline(sb), kNoDeadline);
+
+    store.assign(sa, make("A2", Priority::Medium, Status::Done, ""));
+    EXPECT_EQ(store.record(sa).title, "A2");
+    EXPECT_EQ(store.record(sa).id, a);
+    EXPECT_EQ(store.priority(sa), Priority::Medium);
+    EXPECT_EQ(store.status(sa), Status::Done);
+    EXPECT_EQ(store.deadline(sa), kNoDeadline);
+}
+
+TEST(TaskStoreTests, CompactionKeepsColumnsAligned) {
+    TaskStore store;
+    std::vector<TaskId> ids;
+    for (int i = 0; i < 100; ++i) {
+        ids.push_back(store.add(make("T" + std::to_string(i), static_cast<Priority>(i % 3),
+                                     i % 2 ? Status::Done : Status::Active)));
+    }
+    for (int i = 0; i < 100; ++i) {
+        if (i % 3 != 1) store.erase(store.find(ids[i]));
+    }
+    // Надгробий было больше половины — хранилище уплотнилось.
+    EXPECT_EQ(store.size(), 33u);
+    EXPECT_LT(store.slot_count(), 100u);
+
+    for (size_t slot = 0; slot < store.slot_count(); ++slot) {
+        const Task& t = store.record(slot);
+        if (t.id == 0) continue;
+        EXPECT_EQ(store.id(slot), t.id);
+        EXPECT_EQ(store.priority(slot), t.priority);
+        EXPECT_EQ(store.status(slot), t.status);
+        EXPECT_EQ(store.find(t.id), slot);
+    }
+}
+
+TEST(TaskStoreTests, RestoreKeepsTombstonesAndIdCounter) {
+    TaskStore store;
+    TaskId a = store.add(make("A", Priority::Low, Status::Active));
+    TaskId b = store.add(make("B", Priority::Low, Status::Active));
+    TaskTable saved = store.records();
+    store.erase(store.find(a));
+    TaskTable with_tombstone = store.records();
+
+    EXPECT_FALSE(store.restore(saved));
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_FALSE(store.restore(with_tombstone));
+    EXPECT_EQ(store.size(), 1u);
+    EXPECT_EQ(store.slot_count(), 2u);
+    EXPECT_EQ(store.find(a), IdIndex::npos);
+    EXPECT_EQ(store.find(b), 1u);
+    // Идентификаторы не переиспользуются после отката.
+    EXPECT_GT(store.add(make("C", Priority::Low, Status::Active)), b);
+}
+
+TEST(TaskStoreTests, TagQueryUsesMaintainedBitmaps) {
+    TagDictionary dictionary;
+    TagId work = dictionary.intern("work");
+    TagId urgent = dictionary.intern("urgent");
+    TagId blocked = dictionary.intern("blocked");
+    TaskStore store;
+    TaskId a = store.add(Task("A", "", Priority::Low, Status::Active, "", {work, urgent}));
+    TaskId b = store.add(Task("B", "", Priority::Low, Status::Active, "", {work, urgent, blocked}));
+    TaskId c = store.add(Task("C", "", Priority::Low, Status::Active, "", {work}));
+    store.add(Task("D", "", Priority::Low, Status::Active, "", {}));
+
+    auto select = [&](const std::string& text) {
+        TagQuery query;
+        std::string error;
+        EXPECT_TRUE(TagQuery::parse(text, query, error)) << error;
+        std::vector<std::string> titles;
+        for (const Task& t : TaskView(store, query.evaluate(store, dictionary))) titles.push_back(t.title);
+        return titles;
+    };
+    using Titles = std::vector<std::string>;
+    EXPECT_EQ(select("work AND urgent AND NOT blocked"), (Titles{"A"}));
+    EXPECT_EQ(select("blocked OR NOT work"), (Titles{"B", "D"}));
+    EXPECT_EQ(select("work AND NOT (urgent OR blocked)"), (Titles{"C"}));
+    EXPECT_EQ(select("\"urgent\""), (Titles{"A", "B"}));
+    EXPECT_EQ(select("missing"), (Titles{}));
+    EXPECT_EQ(select(""), (Titles{"A", "B", "C", "D"}));
+
+    // Множества обновляются при правке и удалении.
+    store.assign(store.find(b), Task("B", "", Priority::Low, Status::Active, "", {work, urgent}));
+    store.erase(store.find(a));
+    EXPECT_EQ(select("work AND urgent AND NOT blocked"), (Titles{"B"}));
+    store.erase(store.find(c));
+    EXPECT_EQ(select("work"), (Titles{"B"}));
+
+    TagQuery query;
+    std::string error;
+    EXPECT_FALSE(TagQuery::parse("work AND", query, error));
+    EXPECT_FALSE(TagQuery::parse("(work", query, error));
+    EXPECT_FALSE(TagQuery::parse("work urgent", query, error));
+    EXPECT_FALSE(TagQuery::parse("\"work", query, error));
+}
+
+TEST(TaskStoreTests, EditsCopyOnWriteAndSnapshotsShareTasks) {
+    TaskStore store;
+    std::vector<TaskId> ids;
+    for (int i = 0; i < 100; ++i) {
+        ids.push_back(store.add(make("T" + std::to_string(i), Priority::Low, Status::Active)));
+    }
+    size_t slot = store.find(ids[40]);
+    TaskTable snapshot = store.records();
+    TaskHandle before = store.handle(slot);
+
+    store.assign(slot, make("changed", Priority::High, Status::Done));
+    // Правка кладёт новую задачу; снимок и старая ручка видят прежнее значение.
+    EXPECT_EQ(store.record(slot).title, "changed");
+    EXPECT_EQ(store.record(slot).id, ids[40]);
+    EXPECT_EQ(before->title, "T40");
+    EXPECT_EQ(snapshot[slot], before);
+    // Остальные задачи не копировались.
+    for (size_t i = 0; i < store.slot_count(); ++i) {
+        if (i != slot) {
+            EXPECT_EQ(snapshot[i], store.handle(i));
+        }
+    }
+
+    // Откат снимком не копирует задачи.
+    store.restore(snapshot);
+    EXPECT_EQ(store.handle(slot), before);
+    EXPECT_EQ(store.size(), 100u);
+}
+
+TEST(TaskStoreTests, SnapshotRestoreIsLazyAndMatchesEagerRestore) {
+    const std::string path = "task_store_lazy_test.bin";
+    TagDictionary dictionary;
+    std::vector<Task> tasks;
+    for (int i = 0; i < 200; ++i) {
+        Task t("T" + std::to_string(i), "D" + std::to_string(i), static_cast<Priority>(i % 3),
+               i % 4 ? Status::Active : Status::Done,
+               i % 7 ? "2030-01-" + std::to_string(10 + i % 19) + " 12:00" : "not a date",
+               {dictionary.intern("tag" + std::to_string(i % 5)), dictionary.intern("all")});
+        t.id = 1000 + i;
+        tasks.push_back(std::move(t));
+    }
+    // Повтор и нулевой идентификатор получают новые — так же, как при обычной загрузке.
+    tasks[10].id = tasks[3].id;
+    tasks[20].id = 0;
+    ASSERT_TRUE(TaskSnapshot::write(path, tasks, dictionary, 0));
+
+    TaskStore eager;
+    EXPECT_TRUE(eager.restore(tasks, true));
+    auto snapshot = std::make_shared<TaskSnapshot>();
+    ASSERT_TRUE(snapshot->open(path));
+    TaskStore lazy;
+    EXPECT_TRUE(lazy.restore(snapshot, snapshot->intern_names(dictionary)));
+    snapshot.reset();
+    expect_same(lazy, eager, dictionary);
+
+    // Правки и удаления несобранных записей.
+    for (TaskStore* store : {&eager, &lazy}) {
+        store->erase(5);
+        store->assign(7, Task("edited", "", Priority::High, Status::Done, "2031-02-03 04:05", {}));
+        store->add(make("added", Priority::Medium, Status::Active));
+    }
+    expect_same(lazy, eager, dictionary);
+    EXPECT_EQ(lazy.record(5).id, 0u);
+    EXPECT_EQ(lazy.record(7).title, "edited");
+    EXPECT_EQ(lazy.record(8).title, "T8");
+    EXPECT_EQ(lazy.record(8).tags, eager.record(8).tags);
+    EXPECT_EQ(lazy.record(20).id, eager.record(20).id);
+
+    // Уплотнение сдвигает позиции — несобранные записи собираются до него.
+    for (TaskStore* store : {&eager, &lazy}) {
+        std::vector<TaskId> doomed;
+        for (size_t slot = 0; slot < 150; ++slot) {
+            if (store->id(slot) != 0) doomed.push_back(store->id(slot));
+        }
+        for (TaskId id : doomed) store->erase(store->find(id));
+    }
+    EXPECT_LT(lazy.slot_count(), tasks.size());
+    expect_same(lazy, eager, dictionary);
+    std::vector<std::string> lazy_titles, eager_titles;
+    for (const Task& t : lazy.tasks()) lazy_titles.push_back(t.title + t.description + t.deadline);
+    for (const Task& t : eager.tasks()) eager_titles.push_back(t.title + t.description + t.deadline);
+    EXPECT_EQ(lazy_titles, eager_titles);
+    std::remove(path.c_str());
+}
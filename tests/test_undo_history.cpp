@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "../include/UndoHistory.h"
+#include "../include/Compression.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+
+TEST(CompressionTests, RoundTripsRepetitiveAndRandomData) {
+    std::string repetitive;
+    for (int i = 0; i < 5000; ++i) repetitive += "task " + std::to_string(i % 50) + " description;";
+    std::string random_bytes;
+    std::mt19937 rng(3);
+    for (int i = 0; i < 70000; ++i) random_bytes += static_cast<char>(rng());
+
+    for (const std::string& raw : {std::string(), std::string("a"), repetitive, random_bytes}) {
+        std::string packed = lz_compress(raw);
+        std::string back;
+        ASSERT_TRUE(lz_decompress(packed, raw.size(), back));
+        EXPECT_EQ(back, raw);
+    }
+    EXPECT_LT(lz_compress(repetitive).size(), repetitive.size() / 4);
+
+    std::string packed = lz_compress(repetitive);
+    std::string back;
+    EXPECT_FALSE(lz_decompress(packed.substr(0, packed.size() / 2), repetitive.size(), back));
+    EXPECT_FALSE(lz_decompress(packed, repetitive.size() + 1, back));
+}
+
+TEST(UndoHistoryTests, SpillsOldEntriesAndPagesThemBackInOrder) {
+    const std::string path = "undo_history_test.tmp";
+    std::remove(path.c_str());
+    {
+        UndoHistory history(path, 4096);
+        for (int i = 0; i < 200; ++i) {
+            TaskChange change;
+            change.kind = i % 2 ? TaskChange::Kind::Assign : TaskChange::Kind::Restore;
+            change.id = static_cast<TaskId>(i + 1);
+            change.slot = static_cast<size_t>(i);
+            Task task("title " + std::to_string(i) + std::string(100, 'x'), "description", Priority::High,
+                      Status::Done, "2030-01-01 10:00", {1, 2, 3});
+            task.id = change.id;
+            change.task = make_task_handle(std::move(task));
+            if (i == 10) {
+                change.kind = TaskChange::Kind::Reset;
+                for (int j = 0; j < 100; ++j) {
+                    Task record("r" + std::to_string(j), "", Priority::Low, Status::Active, "", {});
+                    record.id = static_cast<TaskId>(j + 1);
+                    // Надгробия — пустые ручки.
+                    change.records.push_back(j % 10 ? make_task_handle(std::move(record)) : nullptr);
+                }
+            }
+            // Самая новая запись остаётся в памяти, даже если одна больше бюджета.
+            const size_t newest = UndoHistory::bytes_of(change);
+            history.push(std::move(change));
+            EXPECT_LE(history.memory_bytes(), std::max<size_t>(4096, newest));
+        }
+        EXPECT_EQ(history.size(), 200u);
+        EXPECT_GT(history.spilled(), 150u);
+
+        for (int i = 199; i >= 0; --i) {
+            TaskChange change;
+            ASSERT_TRUE(history.pop(change)) << i;
+            EXPECT_EQ(change.id, static_cast<TaskId>(i + 1));
+            EXPECT_EQ(change.slot, static_cast<size_t>(i));
+            ASSERT_TRUE(change.task);
+            EXPECT_EQ(change.task->title, "title " + std::to_string(i) + std::string(100, 'x'));
+            EXPECT_EQ(change.task->priority, Priority::High);
+            EXPECT_EQ(change.task->status, Status::Done);
+            EXPECT_EQ(change.task->due, parse_deadline("2030-01-01 10:00"));
+            EXPECT_EQ(change.task->tags, (std::vector<TagId>{1, 2, 3}));
+            if (i == 10) {
+                EXPECT_EQ(change.kind, TaskChange::Kind::Reset);
+                ASSERT_EQ(change.records.size(), 100u);
+                EXPECT_FALSE(change.records[90]);
+                ASSERT_TRUE(change.records[99]);
+                EXPECT_EQ(change.records[99]->title, "r99");
+            }
+        }
+        TaskChange none;
+        EXPECT_FALSE(history.pop(none));
+        EXPECT_EQ(history.memory_bytes(), 0u);
+        EXPECT_EQ(history.spilled(), 0u);
+    }
+    // Файл выгрузки удаляется вместе с историей.
+    EXPECT_EQ(std::fopen(path.c_str(), "rb"), nullptr);
+}
+
+TEST(UndoHistoryTests, AccountsForHeapMemoryOfEntries) {
+    Task short_task;
+    short_task.title = "short";
+    TaskChange small;
+    small.task = make_task_handle(short_task);
+    Task long_task;
+    long_task.title = std::string(10000, 'x');
+    long_task.tags.assign(1000, 7);
+    TaskChange large;
+    large.task = make_task_handle(long_task);
+    EXPECT_GE(UndoHistory::bytes_of(large), UndoHistory::bytes_of(small) + 10000 + 1000 * sizeof(TagId));
+    // Общая задача считается так же: хранилище может отпустить её позже.
+    const size_t alone = UndoHistory::bytes_of(large);
+    TaskHandle held = large.task;
+    EXPECT_EQ(UndoHistory::bytes_of(large), alone);
+
+    TaskChange reset;
+    reset.kind = TaskChange::Kind::Reset;
+    for (int i = 0; i < 1000; ++i) reset.records.push_back(make_task_handle(Task()));
+    EXPECT_GE(UndoHistory::bytes_of(reset), UndoHistory::bytes_of(small) + 1000 * sizeof(Task));
+    const size_t unshared = UndoHistory::bytes_of(reset);
+    TaskTable shared = reset.records;
+    EXPECT_EQ(UndoHistory::bytes_of(reset), unshared);
+}
+
+TEST(UndoHistoryTests, SpilledBatchKeepsItsSteps) {
+    const std::string path = "undo_history_batch_test.tmp";
+    UndoHistory history(path, 0);
+    TaskChange batch;
+    batch.kind = TaskChange::Kind::Batch;
+    for (int i = 0; i < 3; ++i) {
+        TaskChange step;
+        step.kind = i == 1 ? TaskChange::Kind::Assign : TaskChange::Kind::Remove;
+        step.id = static_cast<TaskId>(i + 1);
+        if (i == 1) {
+            Task task("old", "", Priority::Low, Status::Active, "", {});
+            task.id = step.id;
+            step.task = make_task_handle(std::move(task));
+        }
+        batch.steps.push_back(std::move(step));
+    }
+    EXPECT_GT(UndoHistory::bytes_of(batch), UndoHistory::bytes_of(TaskChange()) + 3 * sizeof(TaskChange));
+    history.push(std::move(batch));
+    history.push(TaskChange());
+    EXPECT_EQ(history.spilled(), 1u);
+
+    TaskChange change;
+    ASSERT_TRUE(history.pop(change));
+    ASSERT_TRUE(history.pop(change));
+    EXPECT_EQ(change.kind, TaskChange::Kind::Batch);
+    ASSERT_EQ(change.steps.size(), 3u);
+    EXPECT_EQ(change.steps[2].id, 3u);
+    EXPECT_EQ(change.steps[1].kind, TaskChange::Kind::Assign);
+    ASSERT_TRUE(change.steps[1].task);
+    EXPECT_EQ(change.steps[1].task->title, "old");
+}
+
+TEST(UndoHistoryTests, SharedBudgetBoundsUndoAndRedoTogether) {
+    UndoHistory undo("shared_budget_undo.tmp", 8192);
+    UndoHistory redo("shared_budget_redo.tmp");
+    undo.share_budget(redo);
+    auto change = [](int i) {
+        TaskChange c;
+        c.kind = TaskChange::Kind::Assign;
+        c.id = static_cast<TaskId>(i + 1);
+        Task task("task " + std::to_string(i) + std::string(300, '.'), "", Priority::Low, Status::Active, "", {});
+        task.id = c.id;
+        c.task = make_task_handle(std::move(task));
+        return c;
+    };
+    for (int i = 0; i < 200; ++i) undo.push(change(i));
+    // Серия откатов переносит записи в стек повтора, но общий объём остаётся в бюджете.
+    for (int i = 199; i >= 0; --i) {
+        TaskChange c;
+        ASSERT_TRUE(undo.pop(c));
+        EXPECT_EQ(c.id, static_cast<TaskId>(i + 1));
+        redo.push(std::move(c));
+        EXPECT_LE(undo.memory_bytes() + redo.memory_bytes(), 8192u);
+    }
+    EXPECT_GT(redo.spilled(), 0u);
+    for (int i = 0; i < 200; ++i) {
+        TaskChange c;
+        ASSERT_TRUE(redo.pop(c));
+        EXPECT_EQ(c.id, static_cast<TaskId>(i + 1));
+        ASSERT_TRUE(c.task);
+        EXPECT_EQ(c.task->title, "task " + std::to_string(i) + std::string(300, '.'));
+    }
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "../include/UrgencyCache.h"
+#include <random>
+
+TEST(UrgencyCacheTests, ChangesOnlyAtBoundaries) {
+    const DeadlineTime due = 1000000;
+    UrgencyCache cache;
+    cache.advance(due - 2 * 86400);
+    EXPECT_EQ(cache.classify(1, due), Urgency::Normal);
+    EXPECT_EQ(cache.classify(2, kNoDeadline), Urgency::Normal);
+
+    EXPECT_EQ(cache.advance(due - 86400 - 1), 0u);
+    EXPECT_EQ(cache.classify(1, due), Urgency::Normal);
+    EXPECT_EQ(cache.advance(due - 86400), 1u);
+    EXPECT_EQ(cache.classify(1, due), Urgency::Urgent);
+    EXPECT_EQ(cache.advance(due - 1), 0u);
+    EXPECT_EQ(cache.advance(due), 1u);
+    EXPECT_EQ(cache.classify(1, due), Urgency::Normal);
+    EXPECT_EQ(cache.advance(due + 1), 1u);
+    EXPECT_EQ(cache.classify(1, due), Urgency::Overdue);
+    EXPECT_EQ(cache.advance(due + 10 * 86400), 0u);
+
+    // Изменённый дедлайн пересчитывается сразу, старые границы игнорируются.
+    EXPECT_EQ(cache.classify(1, due + 20 * 86400), Urgency::Normal);
+    cache.forget(2);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(UrgencyCacheTests, MatchesDirectClassificationOverTime) {
+    std::mt19937 rng(3);
+    std::vector<DeadlineTime> dues(500);
+    for (auto& due : dues) due = rng() % 2 ? static_cast<DeadlineTime>(rng() % (30 * 86400)) : kNoDeadline;
+
+    UrgencyCache cache;
+    for (DeadlineTime now = 0; now < 32 * 86400; now += rng() % 7200) {
+        cache.advance(now);
+        if (rng() % 10 == 0) dues[rng() % dues.size()] = now + static_cast<DeadlineTime>(rng() % (3 * 86400));
+        for (size_t id = 0; id < dues.size(); ++id) {
+            ASSERT_EQ(cache.classify(id + 1, dues[id]), UrgencyCache::classify_at(dues[id], now)) << now;
+        }
+    }
+}
+
+TEST(UrgencyCacheTests, StaleTransitionsStayBoundedUnderRepeatedEdits) {
+    UrgencyCache cache;
+    cache.advance(0);
+    for (DeadlineTime i = 0; i < 100000; ++i) {
+        TaskId id = static_cast<TaskId>(i % 10) + 1;
+        cache.classify(id, 10 * 86400 + i);
+        if (i % 3 == 0) cache.forget(id);
+    }
+    EXPECT_LE(cache.size(), 10u);
+    EXPECT_LE(cache.pending(), 2 * cache.size() + 64);
+
+    // После пересборки смены срабатывают как прежде.
+    cache.classify(100, 5 * 86400);
+    EXPECT_EQ(cache.advance(4 * 86400), 1u);
+    EXPECT_EQ(cache.classify(100, 5 * 86400), Urgency::Urgent);
+}
@@ -1,10 +1,26 @@
 #include <gtest/gtest.h>
 #include "../include/User.h"
 #include "../include/Task.h"
+#include "../include/TaskSaxLoader.h"
+#include "../include/TaskCodec.h"
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+const Task& nth(const User& user, size_t n) {
+    auto it = user.get_tasks().begin();
+    std::advance(it, n);
+    return *it;
+}
+}
 
 TEST(UserTests, AddTaskIncreasesSize) {
     User user("test_user");
-    Task task{"Title", "Desc", Priority::Medium, Status::Active, "2030-01-01 12:00", {"tag"}};
+    Task task{"Title", "Desc", Priority::Medium, Status::Active, "2030-01-01 12:00", {user.intern_tag("tag")}};
     size_t before = user.get_tasks().size();
 
     user.add_task(task);
@@ -18,7 +34,7 @@ TEST(UserTests, DeleteValidTask) {
     user.add_task(Task{"A", "B", Priority::Low, Status::Done, "2030-01-01 10:00", {}});
     EXPECT_EQ(user.get_tasks().size(), 1);
 
-    user.delete_task(0);
+    user.delete_task(nth(user, 0).id);
     EXPECT_TRUE(user.get_tasks().empty());
 }
 
@@ -36,7 +52,7 @@ TEST(UserTests, SearchFindsMatchingTasks) {
     auto results = user.search_tasks("milk");
 
     ASSERT_EQ(results.size(), 1);
-    EXPECT_EQ(results[0].title, "Buy milk");
+    EXPECT_EQ(results[0]->title, "Buy milk");
 }
 
 TEST(UserTests, SearchFindsNothingIfNoMatch) {
@@ -47,3 +63,732 @@ TEST(UserTests, SearchFindsNothingIfNoMatch) {
 
     EXPECT_TRUE(results.empty());
 }
+
+namespace {
+void remove_user_files(const std::string& name) {
+    std::remove((name + "_tasks.json").c_str());
+    std::remove((name + "_tasks.bin").c_str());
+    std::remove((name + "_tasks.cbor").c_str());
+    std::remove((name + "_tasks.msgpack").c_str());
+    std::remove((name + "_tasks.log").c_str());
+}
+}
+
+TEST(UserPersistenceTests, SaveAppendsToLogAndLoadReplaysIt) {
+    const std::string name = "log_test_user";
+    remove_user_files(name);
+    {
+        User user(name);
+        user.load_from_file();
+        TagId x = user.intern_tag("x");
+        TaskId a = user.add_task(Task{"A", "1", Priority::Low, Status::Active, "2030-01-01 10:00", {x}});
+        TaskId b = user.add_task(Task{"B", "2", Priority::High, Status::Active, "2030-01-02 10:00", {}});
+        user.save_to_file();
+        user.edit_task(a, Task{"A2", "1", Priority::Medium, Status::Done, "2030-01-01 10:00", {x}});
+        user.delete_task(b);
+        user.save_to_file();
+    }
+
+    std::ifstream snapshot(name + "_tasks.bin");
+    EXPECT_FALSE(snapshot.is_open()); // Снимок не переписывался — только журнал.
+
+    User reloaded(name);
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.get_tasks().size(), 1);
+    EXPECT_EQ(nth(reloaded, 0).title, "A2");
+    EXPECT_EQ(nth(reloaded, 0).status, Status::Done);
+    remove_user_files(name);
+}
+
+TEST(UserPersistenceTests, UndoAndCompactionWriteSnapshot) {
+    const std::string name = "snapshot_test_user";
+    remove_user_files(name);
+    {
+        User user(name);
+        user.load_from_file();
+        user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {}});
+        user.add_task(Task{"B", "", Priority::Low, Status::Active, "", {}});
+        user.undo();
+        user.save_to_file();
+        user.add_task(Task{"C", "", Priority::Low, Status::Active, "", {}});
+        user.save_to_file();
+    }
+
+    User reloaded(name);
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.get_tasks().size(), 2);
+    EXPECT_EQ(nth(reloaded, 0).title, "A");
+    EXPECT_EQ(nth(reloaded, 1).title, "C");
+    remove_user_files(name);
+}
+
+TEST(UserPersistenceTests, TornLogTailIsIgnored) {
+    const std::string name = "torn_test_user";
+    remove_user_files(name);
+    {
+        User user(name);
+        user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {}});
+        user.save_to_file();
+    }
+    {
+        std::ofstream log(name + "_tasks.log", std::ios::app);
+        log << "{\"op\":\"add\",\"seq\":2,\"task\":{\"tit";
+    }
+
+    User reloaded(name);
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.get_tasks().size(), 1);
+    reloaded.add_task(Task{"B", "", Priority::Low, Status::Active, "", {}});
+    reloaded.save_to_file();
+
+    User again(name);
+    again.load_from_file();
+    ASSERT_EQ(again.get_tasks().size(), 2);
+    EXPECT_EQ(nth(again, 1).title, "B");
+    remove_user_files(name);
+}
+
+namespace {
+// Пишет журнал из двух добавлений и подставляет между ними строку bad.
+std::string log_with_bad_middle_line(const std::string& name, const std::string& bad) {
+    remove_user_files(name);
+    {
+        User user(name);
+        user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {}});
+        user.save_to_file();
+        user.add_task(Task{"B", "", Priority::Low, Status::Active, "", {}});
+        user.save_to_file();
+    }
+    const std::string path = name + "_tasks.log";
+    std::string first, second;
+    {
+        std::ifstream log(path, std::ios::binary);
+        std::getline(log, first);
+        std::getline(log, second);
+    }
+    std::ofstream log(path, std::ios::binary | std::ios::trunc);
+    log << first << '\n' << bad << '\n' << second << '\n';
+    return path;
+}
+}
+
+TEST(UserPersistenceTests, BadLineInTheMiddleOfTheLogIsALoadErrorAndKeepsTheFile) {
+    const std::string name = "mid_log_test_user";
+    const std::string path = log_with_bad_middle_line(name, "{\"op\":\"add\",\"seq\":");
+    const auto size = std::filesystem::file_size(path);
+
+    User reloaded(name);
+    EXPECT_THROW(reloaded.load_from_file(), std::runtime_error);
+    EXPECT_EQ(std::filesystem::file_size(path), size); // Записи после испорченной строки не отрезаны.
+    remove_user_files(name);
+}
+
+TEST(UserPersistenceTests, LogRecordWithMissingFieldsIsALoadError) {
+    const std::string name = "fields_log_test_user";
+    for (const std::string bad : {"{\"op\":\"delete\",\"id\":1}",
+                                  "{\"op\":\"delete\",\"seq\":5}",
+                                  "{\"op\":\"add\",\"seq\":5,\"task\":{\"id\":9,\"title\":\"C\"}}",
+                                  "{\"op\":\"edit\",\"seq\":5,\"task\":[]}",
+                                  "{\"seq\":\"5\"}",
+                                  "[]"}) {
+        const std::string path = log_with_bad_middle_line(name, bad);
+        const auto size = std::filesystem::file_size(path);
+        User reloaded(name);
+        EXPECT_THROW(reloaded.load_from_file(), std::runtime_error) << bad;
+        EXPECT_EQ(std::filesystem::file_size(path), size) << bad;
+    }
+    remove_user_files(name);
+}
+
+TEST(UserPersistenceTests, JsonIsImportedAndBinarySnapshotTakesOver) {
+    const std::string name = "import_test_user";
+    remove_user_files(name);
+    {
+        User user(name);
+        user.add_task(Task{"Imported", "D", Priority::High, Status::Done, "2030-05-01 09:30",
+                           {user.intern_tag("a"), user.intern_tag("b")}});
+        ASSERT_TRUE(user.export_tasks(name + "_tasks.json"));
+    }
+
+    User imported(name);
+    imported.load_from_file();
+    ASSERT_EQ(imported.get_tasks().size(), 1);
+    imported.compact();
+
+    std::remove((name + "_tasks.json").c_str());
+    User reloaded(name);
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.get_tasks().size(), 1);
+    const Task& t = nth(reloaded, 0);
+    EXPECT_EQ(t.title, "Imported");
+    EXPECT_EQ(t.description, "D");
+    EXPECT_EQ(t.priority, Priority::High);
+    EXPECT_EQ(t.status, Status::Done);
+    EXPECT_EQ(t.deadline, "2030-05-01 09:30");
+    EXPECT_EQ(t.due, make_deadline(2030, 4, 1, 9, 30));
+    EXPECT_EQ(reloaded.tags().names(t.tags), (std::vector<std::string>{"a", "b"}));
+    remove_user_files(name);
+}
+
+TEST(UserPersistenceTests, CorruptSnapshotIsALoadErrorNotAnImportFallback) {
+    const std::string name = "corrupt_snapshot_user";
+    remove_user_files(name);
+    {
+        User user(name);
+        user.add_task(Task{"Old", "", Priority::Low, Status::Active, "", {}});
+        ASSERT_TRUE(user.export_tasks(name + "_tasks.json"));
+        user.add_task(Task{"New", "", Priority::Low, Status::Active, "", {}});
+        user.compact();
+        user.delete_task(user.add_task(Task{"Gone", "", Priority::Low, Status::Active, "", {}}));
+        user.save_to_file();
+    }
+    const std::string bin = name + "_tasks.bin";
+    std::filesystem::resize_file(bin, std::filesystem::file_size(bin) - 1);
+
+    // Журнал не применяется к старому JSON: загрузка сообщает об ошибке.
+    User reloaded(name);
+    EXPECT_THROW(reloaded.load_from_file(), std::runtime_error);
+    remove_user_files(name);
+}
+
+TEST(TaskSnapshotTests, RejectsTruncatedFile) {
+    const std::string path = "truncated_snapshot.bin";
+    TagDictionary dictionary;
+    dictionary.intern("unused");
+    TagId t = dictionary.intern("t");
+    ASSERT_TRUE(TaskSnapshot::write(path, {Task{"A", "B", Priority::Low, Status::Active, "", {t, t}}}, dictionary, 7));
+    {
+        TaskSnapshot snapshot;
+        ASSERT_TRUE(snapshot.open(path));
+        EXPECT_EQ(snapshot.seq(), 7u);
+        EXPECT_EQ(snapshot.tag(0, 0), "t");
+        // Имя хранится один раз, неиспользуемые имена не записываются.
+        EXPECT_EQ(snapshot.name_count(), 1u);
+        EXPECT_EQ(snapshot.tag(0, 1), "t");
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    TaskSnapshot broken;
+    EXPECT_FALSE(broken.open(path));
+    std::remove(path.c_str());
+}
+
+namespace {
+/// Перезаписывает 8 байт файла, как это сделал бы повреждённый диск.
+void patch_u64(const std::string& path, uint64_t offset, uint64_t value) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+}
+
+TEST(TaskSnapshotTests, RejectsOffsetsThatWrapAround) {
+    const std::string path = "wrapping_snapshot.bin";
+    TagDictionary dictionary;
+    TagId t = dictionary.intern("t");
+    const std::vector<Task> tasks{Task{"A", "B", Priority::Low, Status::Active, "", {t}}};
+    const uint64_t record = sizeof(TaskSnapshot::Header);
+    // Смещение около 2^64: сумма с длиной переполняется и проходила бы проверку «<= размера кучи».
+    for (size_t field : {offsetof(TaskSnapshot::Record, title), offsetof(TaskSnapshot::Record, first_tag)}) {
+        ASSERT_TRUE(TaskSnapshot::write(path, tasks, dictionary, 1));
+        patch_u64(path, record + field, ~uint64_t(0));
+        TaskSnapshot broken;
+        EXPECT_FALSE(broken.open(path)) << field;
+    }
+    ASSERT_TRUE(TaskSnapshot::write(path, tasks, dictionary, 1));
+    patch_u64(path, record + tasks.size() * sizeof(TaskSnapshot::Record) + offsetof(TaskSnapshot::TagRef, offset),
+              ~uint64_t(0));
+    TaskSnapshot broken_name;
+    EXPECT_FALSE(broken_name.open(path));
+    std::remove(path.c_str());
+}
+
+TEST(TaskSaxLoaderTests, LoadsWrappedAndBareArrays) {
+    std::vector<Task> tasks;
+    TagDictionary dictionary;
+    std::istringstream wrapped(R"({"seq": 5, "tasks": [
+        {"title": "A", "description": "d", "priority": "High", "status": "Done",
+         "deadline": "2030-01-01 10:00", "tags": ["x", "y"], "extra": {"tags": ["z"]}}]})");
+    TaskSaxLoader loader(tasks, dictionary);
+    ASSERT_TRUE(loader.load(wrapped));
+    EXPECT_EQ(loader.seq(), 5u);
+    ASSERT_EQ(tasks.size(), 1);
+    EXPECT_EQ(tasks[0].title, "A");
+    EXPECT_EQ(tasks[0].priority, Priority::High);
+    EXPECT_EQ(tasks[0].status, Status::Done);
+    EXPECT_EQ(dictionary.names(tasks[0].tags), (std::vector<std::string>{"x", "y"}));
+
+    std::istringstream bare(R"([{"title": "B", "description": "", "priority": "Low", "status": "Active",
+        "deadline": "", "tags": []}])");
+    TaskSaxLoader bareLoader(tasks, dictionary);
+    ASSERT_TRUE(bareLoader.load(bare));
+    ASSERT_EQ(tasks.size(), 2);
+    EXPECT_EQ(tasks[1].title, "B");
+}
+
+TEST(TaskSaxLoaderTests, RejectsIncompleteTask) {
+    std::vector<Task> tasks;
+    TagDictionary dictionary;
+    std::istringstream in(R"([{"title": "A"}])");
+    TaskSaxLoader loader(tasks, dictionary);
+    EXPECT_FALSE(loader.load(in));
+    EXPECT_TRUE(tasks.empty());
+}
+
+TEST(UserPersistenceTests, ExportImportRoundTripsEveryCodec) {
+    User user("codec_user");
+    user.add_task(Task{"A", "quote \" and \\", Priority::Medium, Status::Done, "2030-01-01 10:00",
+                       {user.intern_tag("x"), user.intern_tag("y")}});
+    user.add_task(Task{"B", "", Priority::High, Status::Active, "", {}});
+
+    for (const TaskCodec* codec : TaskCodec::all()) {
+        const std::string path = std::string("codec_export") + codec->extension();
+        ASSERT_TRUE(user.export_tasks(path)) << codec->name();
+
+        User imported("codec_user2");
+        ASSERT_TRUE(imported.import_tasks(path)) << codec->name();
+        ASSERT_EQ(imported.get_tasks().size(), 2) << codec->name();
+        EXPECT_EQ(nth(imported, 0).description, "quote \" and \\");
+        EXPECT_EQ(imported.tags().names(nth(imported, 0).tags), (std::vector<std::string>{"x", "y"}));
+        EXPECT_EQ(nth(imported, 1).priority, Priority::High);
+        std::remove(path.c_str());
+    }
+    EXPECT_FALSE(user.export_tasks("codec_export.txt"));
+}
+
+TEST(UserPersistenceTests, LoadImportsMessagePackWhenNoSnapshotExists) {
+    const std::string name = "msgpack_user";
+    remove_user_files(name);
+    {
+        User user(name);
+        user.add_task(Task{"Packed", "", Priority::Low, Status::Active, "", {}});
+        ASSERT_TRUE(user.export_tasks(name + "_tasks.msgpack"));
+    }
+    User reloaded(name);
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.get_tasks().size(), 1);
+    EXPECT_EQ(nth(reloaded, 0).title, "Packed");
+    remove_user_files(name);
+}
+
+TEST(UserTests, IdsAreStableAcrossDeletesAndUndo) {
+    User user("test_user");
+    TaskId a = user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {}});
+    TaskId b = user.add_task(Task{"B", "", Priority::Low, Status::Active, "", {}});
+    TaskId c = user.add_task(Task{"C", "", Priority::Low, Status::Active, "", {}});
+    EXPECT_NE(a, b);
+    EXPECT_NE(b, c);
+
+    user.delete_task(a);
+    ASSERT_NE(user.find_task(c), nullptr);
+    EXPECT_EQ(user.find_task(c)->title, "C");
+    EXPECT_EQ(user.find_task(a), nullptr);
+
+    user.edit_task(b, Task{"B2", "", Priority::High, Status::Done, "", {}});
+    EXPECT_EQ(user.find_task(b)->title, "B2");
+    EXPECT_EQ(user.find_task(b)->id, b);
+
+    user.undo();
+    user.undo();
+    ASSERT_NE(user.find_task(a), nullptr);
+    EXPECT_EQ(user.find_task(b)->title, "B");
+
+    TaskId d = user.add_task(Task{"D", "", Priority::Low, Status::Active, "", {}});
+    EXPECT_GT(d, c);
+}
+
+TEST(UserTests, DeletesLeaveTombstonesThatCompactAway) {
+    User user("test_user");
+    std::vector<TaskId> ids;
+    for (int i = 0; i < 1000; ++i) {
+        ids.push_back(user.add_task(Task{"T" + std::to_string(i), "", Priority::Low, Status::Active, "", {}}));
+    }
+    for (int i = 0; i < 999; i += 2) user.delete_task(ids[i]);
+
+    EXPECT_EQ(user.get_tasks().size(), 500);
+    size_t seen = 0;
+    for (const Task& t : user.get_tasks()) {
+        EXPECT_EQ(t.title, "T" + std::to_string(2 * seen + 1));
+        ++seen;
+    }
+    EXPECT_EQ(seen, 500);
+    EXPECT_EQ(user.get_tasks().back().title, "T999");
+
+    // После уплотнения идентификаторы по-прежнему находят свои задачи.
+    for (int i = 1; i < 1000; i += 2) {
+        ASSERT_NE(user.find_task(ids[i]), nullptr);
+        EXPECT_EQ(user.find_task(ids[i])->title, "T" + std::to_string(i));
+    }
+    EXPECT_EQ(user.search_tasks("T1").size(), 56);
+
+    user.undo();
+    EXPECT_EQ(user.get_tasks().size(), 501);
+    ASSERT_NE(user.find_task(ids[998]), nullptr);
+}
+
+TEST(UserTests, RenamingTagUpdatesEveryTaskAndSurvivesReload) {
+    const std::string name = "tag_rename_user";
+    remove_user_files(name);
+    {
+        User user(name);
+        TagId work = user.intern_tag("work");
+        user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {work}});
+        user.add_task(Task{"B", "", Priority::Low, Status::Active, "", {work, user.intern_tag("home")}});
+        user.add_task(Task{"C", "", Priority::Low, Status::Active, "", {}});
+        EXPECT_EQ(user.filter_by_tag("work").size(), 2u);
+
+        EXPECT_FALSE(user.rename_tag("work", "home"));
+        EXPECT_TRUE(user.rename_tag("work", "job"));
+        EXPECT_EQ(user.tags().find("work"), TagDictionary::npos);
+        EXPECT_EQ(user.tags().find("job"), work);
+        EXPECT_TRUE(user.filter_by_tag("work").empty());
+        EXPECT_EQ(user.filter_by_tag("job").size(), 2u);
+        user.save_to_file();
+    }
+
+    User reloaded(name);
+    reloaded.load_from_file();
+    ASSERT_EQ(reloaded.filter_by_tag("job").size(), 2u);
+    EXPECT_EQ(reloaded.tags().names(nth(reloaded, 1).tags), (std::vector<std::string>{"job", "home"}));
+    reloaded.compact();
+
+    User fromSnapshot(name);
+    fromSnapshot.load_from_file();
+    EXPECT_EQ(fromSnapshot.filter_by_tag("job").size(), 2u);
+    EXPECT_TRUE(fromSnapshot.filter_by_tag("work").empty());
+    remove_user_files(name);
+}
+
+TEST(UserTests, StatusAndPriorityViewsFollowMutations) {
+    User user("partition_user");
+    TaskId a = user.add_task(Task{"A", "", Priority::High, Status::Active, "", {}});
+    TaskId b = user.add_task(Task{"B", "", Priority::High, Status::Done, "", {}});
+    user.add_task(Task{"C", "", Priority::Low, Status::Active, "", {}});
+
+    auto titles = [](const TaskView& view) {
+        std::vector<std::string> out;
+        for (const Task& t : view) out.push_back(t.title);
+        return out;
+    };
+    using Titles = std::vector<std::string>;
+    EXPECT_EQ(titles(user.filter_by_status(Status::Active)), (Titles{"A", "C"}));
+    EXPECT_EQ(titles(user.filter_by_priority(Priority::High)), (Titles{"A", "B"}));
+    EXPECT_EQ(titles(user.filter_by_status_and_priority(Status::Active, Priority::High)), (Titles{"A"}));
+
+    user.edit_task(b, Task{"B", "", Priority::High, Status::Active, "", {}});
+    user.delete_task(a);
+    EXPECT_EQ(titles(user.filter_by_status_and_priority(Status::Active, Priority::High)), (Titles{"B"}));
+    EXPECT_TRUE(user.filter_by_status(Status::Done).empty());
+
+    user.undo();
+    user.undo();
+    EXPECT_EQ(titles(user.filter_by_status(Status::Done)), (Titles{"B"}));
+    TaskView copy = user.filter_by_status_and_priority(Status::Active, Priority::High);
+    TaskView moved = std::move(copy);
+    EXPECT_EQ(titles(moved), (Titles{"A"}));
+}
+
+TEST(UserTests, IncrementalStatsMatchFullRecomputeUnderRandomOperations) {
+    const std::string deadlines[] = {"", "2030-01-01 10:00", "2030-01-02 12:00", "2030-02-10 08:30"};
+    std::mt19937 rng(2024);
+    User user("stats_user");
+    std::vector<TaskId> ids;
+
+    for (int step = 0; step < 3000; ++step) {
+        Task t{"T" + std::to_string(step), "", static_cast<Priority>(rng() % 3),
+               rng() % 2 ? Status::Active : Status::Done, deadlines[rng() % 4], {}};
+        unsigned op = rng() % 10;
+        if (op < 4 || ids.empty()) {
+            ids.push_back(user.add_task(t));
+        } else if (op < 7) {
+            user.edit_task(ids[rng() % ids.size()], t);
+        } else if (op < 9) {
+            size_t i = rng() % ids.size();
+            user.delete_task(ids[i]);
+            ids.erase(ids.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            user.undo();
+            ids.clear();
+            for (const Task& task : user.get_tasks()) ids.push_back(task.id);
+        }
+
+        std::map<Priority, int> stats;
+        std::map<std::string, int> calendar;
+        for (const Task& task : user.get_tasks()) {
+            stats[task.priority]++;
+            calendar[task.deadline]++;
+        }
+        ASSERT_EQ(user.get_priority_stats(), stats) << "step " << step;
+        ASSERT_EQ(user.get_deadline_calendar(), calendar) << "step " << step;
+    }
+}
+
+TEST(UserTests, DeadlineOrderFollowsEditsAndDeletes) {
+    User user("deadline_order_user");
+    TaskId a = user.add_task(Task{"A", "", Priority::Low, Status::Active, "2030-03-01 10:00", {}});
+    TaskId b = user.add_task(Task{"B", "", Priority::Low, Status::Active, "2030-01-01 10:00", {}});
+    user.add_task(Task{"C", "", Priority::Low, Status::Active, "", {}});
+    user.add_task(Task{"D", "", Priority::Low, Status::Active, "2030-01-01 10:00", {}});
+
+    auto titles = [](const DeadlineView& view) {
+        std::vector<std::string> out;
+        for (const Task& t : view) out.push_back(t.title);
+        return out;
+    };
+    using Titles = std::vector<std::string>;
+    EXPECT_EQ(titles(user.tasks_by_deadline()), (Titles{"B", "D", "A", "C"}));
+    EXPECT_EQ(titles(user.tasks_by_deadline(true)), (Titles{"C", "A", "D", "B"}));
+
+    user.edit_task(a, Task{"A", "", Priority::Low, Status::Active, "2029-12-31 23:59", {}});
+    user.delete_task(b);
+    EXPECT_EQ(titles(user.tasks_by_deadline()), (Titles{"A", "D", "C"}));
+    user.undo();
+    EXPECT_EQ(titles(user.tasks_by_deadline()), (Titles{"A", "B", "D", "C"}));
+}
+
+TEST(UserTests, DueBetweenReturnsHalfOpenRange) {
+    User user("due_between_user");
+    user.add_task(Task{"Jan31", "", Priority::Low, Status::Active, "2030-01-31 23:59", {}});
+    user.add_task(Task{"Feb1", "", Priority::Low, Status::Active, "2030-02-01 00:00", {}});
+    user.add_task(Task{"Feb15", "", Priority::Low, Status::Active, "2030-02-15 12:00", {}});
+    user.add_task(Task{"Mar1", "", Priority::Low, Status::Active, "2030-03-01 00:00", {}});
+    user.add_task(Task{"None", "", Priority::Low, Status::Active, "", {}});
+
+    auto titles = [](const DeadlineView& view) {
+        std::vector<std::string> out;
+        for (const Task& t : view) out.push_back(t.title);
+        return out;
+    };
+    using Titles = std::vector<std::string>;
+    DeadlineTime feb = make_deadline(2030, 1, 1);
+    DeadlineTime mar = make_deadline(2030, 2, 1);
+    EXPECT_EQ(titles(user.tasks_due_between(feb, mar)), (Titles{"Feb1", "Feb15"}));
+    EXPECT_EQ(titles(user.tasks_due_between(feb, mar, true)), (Titles{"Feb15", "Feb1"}));
+    EXPECT_EQ(make_deadline(2030, 12, 1), make_deadline(2031, 0, 1));
+    EXPECT_TRUE(user.tasks_due_between(mar, feb).empty());
+    EXPECT_EQ(user.tasks_due_between(make_deadline(2030, 0, 1), make_deadline(2031, 0, 1)).size(), 4u);
+}
+
+TEST(UserTests, DeadlineIsParsedOnceAndInvalidOnesAreFlagged) {
+    Task valid{"A", "", Priority::Low, Status::Active, "2030-05-01 09:30", {}};
+    EXPECT_EQ(valid.due, make_deadline(2030, 4, 1, 9, 30));
+    EXPECT_FALSE(valid.deadline_invalid());
+    Task invalid{"B", "", Priority::Low, Status::Active, "tomorrow", {}};
+    EXPECT_EQ(invalid.due, kNoDeadline);
+    EXPECT_TRUE(invalid.deadline_invalid());
+    EXPECT_FALSE(Task().deadline_invalid());
+
+    TagDictionary dictionary;
+    Task parsed = Task::from_json(valid.to_json(dictionary), dictionary);
+    EXPECT_EQ(parsed.due, valid.due);
+
+    User user("parsed_deadline_user");
+    TaskId id = user.add_task(invalid);
+    user.add_task(valid);
+    EXPECT_EQ(user.tasks_by_deadline().begin()->title, "A");
+    Task edited = invalid;
+    edited.set_deadline("2029-01-01 00:00");
+    user.edit_task(id, edited);
+    EXPECT_EQ(user.find_task(id)->due, make_deadline(2029, 0, 1));
+    EXPECT_EQ(user.tasks_by_deadline().begin()->title, "B");
+}
+
+TEST(UserTests, NextUpFollowsStatusPriorityAndDeadline) {
+    User user("next_up_user");
+    TaskId low = user.add_task(Task{"Low soon", "", Priority::Low, Status::Active, "2030-01-01 10:00", {}});
+    TaskId high_late = user.add_task(Task{"High late", "", Priority::High, Status::Active, "2030-06-01 10:00", {}});
+    user.add_task(Task{"High none", "", Priority::High, Status::Active, "", {}});
+    TaskId high_early = user.add_task(Task{"High early", "", Priority::High, Status::Active, "2030-02-01 10:00", {}});
+    user.add_task(Task{"Done high", "", Priority::High, Status::Done, "2029-01-01 10:00", {}});
+
+    auto titles = [&](size_t k) {
+        std::vector<std::string> out;
+        for (const Task* t : user.next_up(k)) out.push_back(t->title);
+        return out;
+    };
+    using Titles = std::vector<std::string>;
+    EXPECT_EQ(titles(3), (Titles{"High early", "High late", "High none"}));
+    EXPECT_EQ(titles(10).size(), 5u);
+    EXPECT_EQ(titles(10).back(), "Done high");
+
+    Task promoted = *user.find_task(low);
+    promoted.priority = Priority::High;
+    user.edit_task(low, promoted);
+    Task finished = *user.find_task(high_early);
+    finished.status = Status::Done;
+    user.edit_task(high_early, finished);
+    user.delete_task(high_late);
+    EXPECT_EQ(titles(3), (Titles{"Low soon", "High none", "Done high"}));
+}
+
+namespace {
+/// Видимое состояние списка: идентификаторы и поля задач по порядку.
+std::vector<std::string> state_of(const User& user) {
+    std::vector<std::string> out;
+    for (const Task& t : user.get_tasks()) {
+        out.push_back(std::to_string(t.id) + "|" + t.title + "|" + priorityToString(t.priority) + "|" +
+                      statusToString(t.status) + "|" + t.deadline);
+    }
+    return out;
+}
+}
+
+TEST(UserTests, UndoRedoWalkTheCommandLogUnderRandomOperations) {
+    const std::string name = "undo_redo_user";
+    remove_user_files(name);
+    std::mt19937 rng(77);
+    std::vector<std::vector<std::string>> states;
+    size_t current = 0;
+    {
+        User user(name);
+        states.push_back(state_of(user));
+        std::vector<TaskId> ids;
+        for (int step = 0; step < 2000; ++step) {
+            unsigned op = rng() % 10;
+            if (op < 3) {
+                user.undo();
+                if (current > 0) --current;
+            } else if (op < 5) {
+                user.redo();
+                if (current + 1 < states.size()) ++current;
+            } else {
+                Task t{"T" + std::to_string(step), "", static_cast<Priority>(rng() % 3),
+                       rng() % 2 ? Status::Active : Status::Done, rng() % 2 ? "2030-01-01 10:00" : "", {}};
+                ids.clear();
+                for (const Task& task : user.get_tasks()) ids.push_back(task.id);
+                if (op < 7 || ids.empty()) {
+                    user.add_task(t);
+                } else if (op < 9) {
+                    user.edit_task(ids[rng() % ids.size()], t);
+                } else {
+                    user.delete_task(ids[rng() % ids.size()]);
+                }
+                // Новое изменение отбрасывает ветку повтора.
+                states.resize(current + 1);
+                states.push_back(state_of(user));
+                ++current;
+            }
+            ASSERT_EQ(state_of(user), states[current]) << "step " << step;
+        }
+        user.save_to_file();
+    }
+
+    // Откаты записаны в журнал обычными записями: набор задач переживает перезагрузку.
+    User reloaded(name);
+    reloaded.load_from_file();
+    std::vector<std::string> expected = states[current];
+    std::vector<std::string> actual = state_of(reloaded);
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, expected);
+    remove_user_files(name);
+}
+
+TEST(UserTests, UndoPagesSpilledHistoryBackIn) {
+    const std::string name = "undo_budget_user";
+    remove_user_files(name);
+    User user(name);
+    user.set_undo_budget(8 * 1024);
+    std::vector<std::vector<std::string>> states{state_of(user)};
+    TaskId id = user.add_task(Task("first", "", Priority::Low, Status::Active, "", {}));
+    states.push_back(state_of(user));
+    for (int i = 0; i < 300; ++i) {
+        user.edit_task(id, Task("edit " + std::to_string(i) + std::string(200, '.'), "", Priority::Medium,
+                                Status::Active, "2030-01-01 10:00", {}));
+        states.push_back(state_of(user));
+    }
+    EXPECT_GT(user.undo_history().spilled(), 0u);
+    EXPECT_LE(user.undo_history().memory_bytes(), 8u * 1024);
+
+    for (size_t i = states.size() - 1; i > 0; --i) {
+        user.undo();
+        ASSERT_EQ(state_of(user), states[i - 1]) << i;
+    }
+    EXPECT_TRUE(user.undo_history().empty());
+    for (size_t i = 1; i < states.size(); ++i) user.redo();
+    EXPECT_EQ(state_of(user), states.back());
+    remove_user_files(name);
+}
+
+TEST(UserTests, SearchResultsAreSharedHandlesThatSurviveEdits) {
+    User user("test_user");
+    TaskId id = user.add_task(Task{"Buy milk", "", Priority::High, Status::Active, "", {}});
+    auto results = user.search_tasks("milk");
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].get(), user.find_task(id));
+
+    user.edit_task(id, Task{"Buy bread", "", Priority::Low, Status::Active, "", {}});
+    // Результат поиска держит прежнюю задачу, список — новую.
+    EXPECT_EQ(results[0]->title, "Buy milk");
+    EXPECT_EQ(user.find_task(id)->title, "Buy bread");
+    user.undo();
+    EXPECT_EQ(user.find_task(id), results[0].get());
+}
+
+TEST(UserPersistenceTests, ApplyBatchIsOneUndoStepAndOneSave) {
+    const std::string name = "batch_test_user";
+    remove_user_files(name);
+    std::vector<std::string> before, after;
+    {
+        User user(name);
+        user.load_from_file();
+        TaskId a = user.add_task(Task{"A", "", Priority::Low, Status::Active, "", {}});
+        TaskId b = user.add_task(Task{"B", "", Priority::Low, Status::Active, "", {}});
+        before = state_of(user);
+
+        std::vector<TaskOp> ops;
+        ops.push_back(TaskOp::add(Task{"C", "", Priority::High, Status::Active, "2030-01-01 10:00", {}}));
+        ops.push_back(TaskOp::edit(a, Task{"A2", "", Priority::Medium, Status::Done, "", {}}));
+        ops.push_back(TaskOp::remove(b));
+        ops.push_back(TaskOp::remove(12345));
+        std::vector<TaskId> ids = user.apply_batch(std::move(ops));
+        ASSERT_EQ(ids.size(), 4u);
+        EXPECT_NE(ids[0], 0u);
+        EXPECT_EQ(ids[1], a);
+        EXPECT_EQ(ids[2], b);
+        EXPECT_EQ(ids[3], 0u);
+        after = state_of(user);
+        ASSERT_EQ(after.size(), 2u);
+
+        // Вся пачка откатывается и повторяется одним шагом.
+        user.undo();
+        EXPECT_EQ(state_of(user), before);
+        user.redo();
+        EXPECT_EQ(state_of(user), after);
+        user.save_to_file();
+    }
+    std::ifstream snapshot(name + "_tasks.bin");
+    EXPECT_FALSE(snapshot.is_open()); // Небольшая пачка уходит в журнал.
+
+    User reloaded(name);
+    reloaded.load_from_file();
+    EXPECT_EQ(state_of(reloaded), after);
+    remove_user_files(name);
+}
+
+TEST(UserPersistenceTests, LargeBatchIsSavedAsSnapshot) {
+    const std::string name = "large_batch_test_user";
+    remove_user_files(name);
+    {
+        User user(name);
+        user.load_from_file();
+        std::vector<TaskOp> ops;
+        for (int i = 0; i < 3000; ++i) {
+            ops.push_back(TaskOp::add(Task{"T" + std::to_string(i), "", Priority::Low, Status::Active, "", {}}));
+        }
+        user.apply_batch(std::move(ops));
+        EXPECT_EQ(user.get_tasks().size(), 3000u);
+        user.save_to_file();
+        user.undo();
+        EXPECT_TRUE(user.get_tasks().empty());
+        user.redo();
+        user.save_to_file();
+    }
+    std::ifstream log(name + "_tasks.log");
+    std::string line;
+    EXPECT_FALSE(std::getline(log, line)); // Записей журнала нет — только снимок.
+
+    User reloaded(name);
+    reloaded.load_from_file();
+    EXPECT_EQ(reloaded.get_tasks().size(), 3000u);
+    remove_user_files(name);
+}